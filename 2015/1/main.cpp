@@ -1,37 +1,66 @@
+#include "../../random.h"
 #include "../../solver.h"
-
-#include <fstream>
-#include <unordered_map>
+#include "../../utils.h"
 
 namespace Year2015::Day1 {
     using Base = ::Common::Solver<long>;
 
     class Solver : public Base {
         using Base::Solver;
-        const std::unordered_map<char, int> FLOOR_CHANGE_MAP = std::unordered_map<char, int>{{'(', 1}, {')', -1}};
+        static constexpr auto FLOOR_CHANGE_MAP = Utils::CharTable<int>{{'(', 1}, {')', -1}};
 
-      protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            auto floor = 0;
-            auto i = 0;
-            auto basement_reaching_idx = -1;
-            char c;
-            while (++i, input >> c) {
-                floor += FLOOR_CHANGE_MAP.at(c);
-                if (floor == -1 && basement_reaching_idx == -1) {
-                    basement_reaching_idx = i;
+      public:
+        // ~7000 parentheses per scale, leaning slightly towards going up.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 7000 * scale; ++i) {
+                input += random.chance(51, 100) ? '(' : ')';
+            }
+            return input + '\n';
+        }
+
+        // Each character moves Santa on its own, so chunks can be taken as they come.
+        class Incremental : public Common::IncrementalSolver<long> {
+          public:
+            void feed(std::string_view chunk) override {
+                for (const auto c : chunk) {
+                    if (Utils::is_whitespace(c)) {
+                        continue;
+                    }
+                    ++position;
+
+                    floor += FLOOR_CHANGE_MAP.at(c);
+                    if (floor == -1 && basement_reaching_idx == -1) {
+                        basement_reaching_idx = position;
+                    }
                 }
             }
 
-            return Base::Answers{Base::Answer{"Santa floor", floor},
-                                 Base::Answer{"Santa basement reaching position", basement_reaching_idx}};
-        }
+            Base::Answers snapshot() const override {
+                return Base::Answers{Base::Answer{"Santa floor", floor},
+                                     Base::Answer{"Santa basement reaching position", basement_reaching_idx}};
+            }
+
+            Base::Answers finish() override { return snapshot(); }
+
+          private:
+            long floor = 0;
+            long position = 0;
+            long basement_reaching_idx = -1;
+        };
+
+      protected:
+        InputMode input_mode() const override { return InputMode::mapped; }
+
+        Base::Answers solve_mapped(std::string_view input) const override { return Incremental{}.solve(input); }
     };
 } // namespace Year2015::Day1
 
+static const auto registration = Common::Registration<Year2015::Day1::Solver>{2015, 1};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2015::Day1::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
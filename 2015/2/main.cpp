@@ -1,6 +1,9 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
-#include <fstream>
+#include <algorithm>
+#include <string_view>
 
 namespace Year2015::Day2 {
     using Base = ::Common::Solver<long>;
@@ -8,14 +11,38 @@ namespace Year2015::Day2 {
     class Solver : public Base {
         using Base::Solver;
 
-      protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            auto surface_area{0};
-            auto ribbon_length{0};
+      public:
+        // 1000 boxes per scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 1000 * scale; ++i) {
+                input += std::to_string(random.between(1, 30)) + 'x' + std::to_string(random.between(1, 30)) + 'x' +
+                    std::to_string(random.between(1, 30)) + '\n';
+            }
+            return input;
+        }
+
+        // One "LxWxH" box per line.
+        struct BoxFold {
+            long surface_area = 0;
+            long ribbon_length = 0;
+
+            void add(std::string_view line) {
+                line = Utils::trim(line);
+                if (line.empty()) {
+                    return;
+                }
+
+                const auto first_x = line.find('x');
+                const auto second_x = line.find('x', first_x + 1);
+                if (first_x == std::string_view::npos || second_x == std::string_view::npos) {
+                    throw Error{"malformed_input"};
+                }
+                const auto l = Utils::str_to_int<int>(line.substr(0, first_x));
+                const auto w = Utils::str_to_int<int>(line.substr(first_x + 1, second_x - first_x - 1));
+                const auto h = Utils::str_to_int<int>(line.substr(second_x + 1));
 
-            int l, w, h;
-            char delims[2];
-            while (input >> l >> delims[0] >> w >> delims[1] >> h && delims[0] == 'x' && delims[1] == 'x') {
                 const auto lw = l * w;
                 const auto wh = w * h;
                 const auto hl = h * l;
@@ -27,15 +54,22 @@ namespace Year2015::Day2 {
                 ribbon_length += lw * h + std::min(std::min(2 * l + 2 * w, 2 * w + 2 * h), 2 * h + 2 * l);
             }
 
-            return Base::Answers{Base::Answer{"Total area needed", surface_area},
-                                 Base::Answer{"Total ribbon needed", ribbon_length}};
-        }
+            Base::Answers answers() const {
+                return Base::Answers{Base::Answer{"Total area needed", surface_area},
+                                     Base::Answer{"Total ribbon needed", ribbon_length}};
+            }
+        };
+        using Incremental = Common::RecordFoldSolver<long, BoxFold>;
+
+      protected:
+        Base::Answers solve(std::istream &input) const override { return Incremental{}.solve(input); }
     };
 } // namespace Year2015::Day2
 
+static const auto registration = Common::Registration<Year2015::Day2::Solver>{2015, 2};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2015::Day2::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
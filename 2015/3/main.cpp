@@ -1,10 +1,11 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
-#include <fstream>
-#include <functional>
+#include <limits>
+#include <memory_resource>
 #include <tuple>
 #include <type_traits>
-#include <unordered_map>
 #include <unordered_set>
 
 namespace Year2015::Day3 {
@@ -14,8 +15,9 @@ namespace Year2015::Day3 {
         int x, y;
 
         bool operator==(const Point &other) const { return x == other.x && y == other.y; }
+        Point operator+(const Point &other) const { return Point{x + other.x, y + other.y}; }
 
-        struct Hash : public std::unary_function<Point, std::size_t> {
+        struct Hash {
             std::size_t operator()(const Point &p) const {
                 static_assert(sizeof(p.x) * 2 == sizeof(size_t),
                               "Point::Hash assumes that x & y can fit into hash key");
@@ -28,29 +30,28 @@ namespace Year2015::Day3 {
     class Solver : public Base {
         using Base::Solver;
 
-        const std::unordered_map<char, std::function<Point(const Point &)>> ACTIONS =
-            std::unordered_map<char, std::function<Point(const Point &)>>{{{'>',
-                                                                            [](const Point &p) {
-                                                                                return Point{p.x + 1, p.y};
-                                                                            }},
-                                                                           {'<',
-                                                                            [](const Point &p) {
-                                                                                return Point{p.x - 1, p.y};
-                                                                            }},
-                                                                           {'^',
-                                                                            [](const Point &p) {
-                                                                                return Point{p.x, p.y + 1};
-                                                                            }},
-                                                                           {'v', [](const Point &p) {
-                                                                                return Point{p.x, p.y - 1};
-                                                                            }}}};
+        static constexpr auto MOVES =
+            Utils::CharTable<Point>{{'>', Point{1, 0}}, {'<', Point{-1, 0}}, {'^', Point{0, 1}}, {'v', Point{0, -1}}};
+
+      public:
+        // 8192 moves per scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr char MOVE_CHARS[] = {'^', 'v', '<', '>'};
+
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 8192 * scale; ++i) {
+                input += random.pick(MOVE_CHARS);
+            }
+            return input + '\n';
+        }
 
       protected:
-        Base::Answers solve(std::ifstream &input) const override {
+        Base::Answers solve(std::istream &input) const override {
+            using Houses = std::pmr::unordered_set<Point, Point::Hash>;
             struct {
-                std::unordered_set<Point, Point::Hash> part1, part2;
-            } houses_with_presents{std::unordered_set<Point, Point::Hash>{Point{0, 0}},
-                                   std::unordered_set<Point, Point::Hash>{Point{0, 0}}};
+                Houses part1, part2;
+            } houses_with_presents{Houses{{Point{0, 0}}, 0, arena()}, Houses{{Point{0, 0}}, 0, arena()}};
 
             struct {
                 struct {
@@ -64,16 +65,16 @@ namespace Year2015::Day3 {
             auto robo_turn{false};
             char c;
             while (input >> c) {
-                const auto action = ACTIONS.at(c);
+                const auto move = MOVES.at(c);
 
-                current_position.part1.santa = action(current_position.part1.santa);
+                current_position.part1.santa = current_position.part1.santa + move;
                 houses_with_presents.part1.insert(current_position.part1.santa);
 
                 if (robo_turn) {
-                    current_position.part2.robo = action(current_position.part2.robo);
+                    current_position.part2.robo = current_position.part2.robo + move;
                     houses_with_presents.part2.insert(current_position.part2.robo);
                 } else {
-                    current_position.part2.santa = action(current_position.part2.santa);
+                    current_position.part2.santa = current_position.part2.santa + move;
                     houses_with_presents.part2.insert(current_position.part2.santa);
                 }
                 robo_turn = !robo_turn;
@@ -85,9 +86,10 @@ namespace Year2015::Day3 {
     };
 } // namespace Year2015::Day3
 
+static const auto registration = Common::Registration<Year2015::Day3::Solver>{2015, 3};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2015::Day3::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -0,0 +1,29 @@
+#include "main.cpp"
+
+#include "../../bench.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace Year2015::Day4 {
+    struct Bench {
+        static Common::Microbenchmark md5_with_number() {
+            static constexpr unsigned long NUMBERS = 10000;
+            static constexpr unsigned long FIRST = 100000;
+
+            // Numbers as far in as the answers usually are, so the same length as the solve hashes.
+            const auto key = std::string{"abcdefgh"};
+            return Common::Microbenchmark{"md5_with_number",
+                                          NUMBERS,
+                                          NUMBERS * (key.size() + std::to_string(FIRST).size()),
+                                          [key, current = std::make_shared<std::ostringstream>()]() {
+                                              for (auto i = FIRST; i < FIRST + NUMBERS; ++i) {
+                                                  Common::do_not_optimize(Solver::md5_with_number(*current, key, i));
+                                              }
+                                          }};
+        }
+    };
+} // namespace Year2015::Day4
+
+int main(int argc, char **argv) { return Common::bench_main(argc, argv, {Year2015::Day4::Bench::md5_with_number()}); }
@@ -1,9 +1,11 @@
 #include "../../solver.h"
 
+#include <array>
 #include <fstream>
 #include <sstream>
 #include <string>
 
+#include <openssl/evp.h>
 #include <openssl/md5.h>
 
 namespace Year2015::Day4 {
@@ -13,7 +15,7 @@ namespace Year2015::Day4 {
         using Base::Solver;
 
       protected:
-        Base::Answers solve(std::ifstream &input) const override {
+        Base::Answers solve(std::istream &input) const override {
             std::string s;
             if (!(input >> s)) {
                 throw Error{"bad_input"};
@@ -26,14 +28,9 @@ namespace Year2015::Day4 {
                 } lowest_five_zeroes, lowest_six_zeroes;
             } answers{};
 
-            unsigned char md5sum[MD5_DIGEST_LENGTH]{};
             std::ostringstream current{};
-            for (unsigned long i = 0; !answers.lowest_five_zeroes.found || !answers.lowest_six_zeroes.found;
-                 ++i, current.str("")) {
-                current << s << i;
-                const auto current_string{current.str()};
-                const auto buf = current_string.c_str();
-                MD5(reinterpret_cast<const unsigned char *>(buf), current_string.size(), md5sum);
+            for (unsigned long i = 0; !answers.lowest_five_zeroes.found || !answers.lowest_six_zeroes.found; ++i) {
+                const auto md5sum = md5_with_number(current, s, i);
 
                 if (md5sum[0] == 0 && md5sum[1] == 0) {
                     // Five zeroes
@@ -52,12 +49,28 @@ namespace Year2015::Day4 {
                 Base::Answer{"Lowest number to produce 5 zeroes MD5", answers.lowest_five_zeroes.value},
                 Base::Answer{"Lowest number to produce 6 zeroes MD5", answers.lowest_six_zeroes.value}};
         }
+
+      private:
+        friend struct Bench;
+
+        using Digest = std::array<unsigned char, MD5_DIGEST_LENGTH>;
+
+        // MD5 of `key` followed by `number` in decimal, formatted into `current`, which is reused between calls.
+        static Digest md5_with_number(std::ostringstream &current, const std::string &key, unsigned long number) {
+            current.str("");
+            current << key << number;
+            const auto current_string{current.str()};
+            auto md5sum = Digest{};
+            EVP_Digest(current_string.c_str(), current_string.size(), md5sum.data(), nullptr, EVP_md5(), nullptr);
+            return md5sum;
+        }
     };
 } // namespace Year2015::Day4
 
+static const auto registration = Common::Registration<Year2015::Day4::Solver>{2015, 4, std::chrono::milliseconds{5000}};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME{"input.txt"};
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2015::Day4::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -0,0 +1,39 @@
+#include "main.cpp"
+
+#include "../../bench.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Year2015::Day5 {
+    struct Bench {
+        static Common::Microbenchmark is_nice() {
+            static constexpr size_t SCALE = 1;
+
+            // Shared, so that the words keep pointing into it as the benchmark is copied about.
+            const auto input = std::make_shared<const std::string>(Solver::generate_input(SCALE, 1));
+            auto words = std::vector<std::string_view>{};
+            for (size_t start = 0; start < input->size();) {
+                const auto end = input->find('\n', start);
+                words.emplace_back(input->data() + start, end - start);
+                start = end + 1;
+            }
+
+            const auto bytes = input->size() - words.size();
+            return Common::Microbenchmark{"is_nice",
+                                          words.size(),
+                                          bytes,
+                                          [input,
+                                           words = std::move(words),
+                                           first_seen = std::make_shared<Solver::FirstSeenPairs>(1 << 16)]() {
+                                              for (const auto word : words) {
+                                                  Common::do_not_optimize(Solver::is_nice(word, *first_seen));
+                                              }
+                                          }};
+        }
+    };
+} // namespace Year2015::Day5
+
+int main(int argc, char **argv) { return Common::bench_main(argc, argv, {Year2015::Day5::Bench::is_nice()}); }
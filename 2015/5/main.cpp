@@ -1,9 +1,13 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <string_view>
+#include <vector>
 
 namespace Year2015::Day5 {
     using Base = ::Common::Solver<unsigned long>;
@@ -11,31 +15,41 @@ namespace Year2015::Day5 {
     class Solver : public Base {
         using Base::Solver;
 
-      protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            std::string word;
-
-            struct {
-                unsigned long part1, part2;
-            } nice_words_count{0, 0};
-
-            while (input >> word) {
-                auto const niceness = is_nice(word);
-                nice_words_count.part1 += niceness.part1 ? 1 : 0;
-                nice_words_count.part2 += niceness.part2 ? 1 : 0;
+      public:
+        // 1000 random 16 letter words per scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 1000 * scale; ++i) {
+                for (size_t j = 0; j < 16; ++j) {
+                    input += static_cast<char>('a' + random.below(26));
+                }
+                input += '\n';
             }
-            return Base::Answers{Base::Answer{"Nice strings count", nice_words_count.part1},
-                                 Base::Answer{"Nice strings count", nice_words_count.part2}};
+            return input;
         }
 
+      protected:
+        Base::Answers solve(std::istream &input) const override { return Incremental{}.solve(input); }
+
       private:
-        const std::unordered_set<char> VOWELS = std::unordered_set<char>{'a', 'e', 'i', 'o', 'u'};
-        const std::unordered_set<std::string> DISALLOWED_TWO_TUPLES =
-            std::unordered_set<std::string>{"ab", "cd", "pq", "xy"};
+        friend struct Bench;
+
+        static constexpr auto VOWELS = Utils::CharTable<bool>{"aeiou"};
+        static constexpr std::array<std::string_view, 4> DISALLOWED_TWO_TUPLES = {"ab", "cd", "pq", "xy"};
 
         using Niceness = struct { bool part1, part2; };
 
-        Niceness is_nice(const std::string &s) const {
+        // Where (plus one) each two character tuple was first seen in the current word, indexed by its two bytes; 0 for
+        // not seen. Kept for the whole solve, & reset after each word by clearing just that word's tuples.
+        using FirstSeenPairs = std::vector<uint32_t>;
+
+        static size_t pair_index(std::string_view two_tuple) {
+            return static_cast<size_t>(static_cast<unsigned char>(two_tuple[0])) << 8 |
+                static_cast<unsigned char>(two_tuple[1]);
+        }
+
+        static Niceness is_nice(std::string_view s, FirstSeenPairs &first_seen) {
             struct {
                 struct {
                     unsigned long vowel_count;
@@ -48,14 +62,12 @@ namespace Year2015::Day5 {
                 } part2;
             } tracker{{0, false, true}, {false, false}};
 
-            auto two_tuples = std::unordered_map<std::string, size_t>{};
-
             const auto char_count = s.size();
             for (size_t i = 0; i < char_count; ++i) {
                 const auto current = s[i];
 
                 // Track vowels
-                if (VOWELS.find(current) != VOWELS.end()) {
+                if (VOWELS.contains(current)) {
                     ++tracker.part1.vowel_count;
                 }
 
@@ -69,16 +81,17 @@ namespace Year2015::Day5 {
                     const auto two_tuple = s.substr(i, 2);
 
                     // Check for disallowed tuple
-                    if (DISALLOWED_TWO_TUPLES.find(two_tuple) != DISALLOWED_TWO_TUPLES.end()) {
+                    if (std::find(DISALLOWED_TWO_TUPLES.begin(), DISALLOWED_TWO_TUPLES.end(), two_tuple) !=
+                        DISALLOWED_TWO_TUPLES.end()) {
                         tracker.part1.all_two_tuples_allowed = false;
                     }
 
                     // Check for non-overlapping two tuple, otherwise store where we saw this tuple.
-                    const auto &found = two_tuples.find(two_tuple);
-                    if (found != two_tuples.end() && found->second != i - 1) {
+                    auto &found = first_seen[pair_index(two_tuple)];
+                    if (found != 0 && found - 1 != i - 1) {
                         tracker.part2.has_non_overlapping_repeated_two_tuple = true;
-                    } else {
-                        two_tuples.emplace(two_tuple, i);
+                    } else if (found == 0) {
+                        found = static_cast<uint32_t>(i + 1);
                     }
                 }
 
@@ -90,17 +103,48 @@ namespace Year2015::Day5 {
                 }
             }
 
+            for (size_t i = 0; i + 1 < char_count; ++i) {
+                first_seen[pair_index(s.substr(i, 2))] = 0;
+            }
+
             return Niceness{tracker.part1.vowel_count >= 3 && tracker.part1.has_consecutive_repeated_character &&
                                 tracker.part1.all_two_tuples_allowed,
                             tracker.part2.has_non_overlapping_repeated_two_tuple &&
                                 tracker.part2.has_skip_character_repeat};
         }
+
+      public:
+        // One word per line, each judged on its own.
+        struct WordFold {
+            struct {
+                unsigned long part1, part2;
+            } nice_words_count{0, 0};
+            FirstSeenPairs first_seen = FirstSeenPairs(1 << 16);
+
+            void add(std::string_view line) {
+                const auto word = Utils::trim(line);
+                if (word.empty()) {
+                    return;
+                }
+
+                auto const niceness = is_nice(word, first_seen);
+                nice_words_count.part1 += niceness.part1 ? 1 : 0;
+                nice_words_count.part2 += niceness.part2 ? 1 : 0;
+            }
+
+            Base::Answers answers() const {
+                return Base::Answers{Base::Answer{"Nice strings count", nice_words_count.part1},
+                                     Base::Answer{"Nice strings count", nice_words_count.part2}};
+            }
+        };
+        using Incremental = Common::RecordFoldSolver<unsigned long, WordFold>;
     };
 } // namespace Year2015::Day5
 
+static const auto registration = Common::Registration<Year2015::Day5::Solver>{2015, 5};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME{"input.txt"};
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2015::Day5::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
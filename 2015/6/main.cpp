@@ -1,109 +1,72 @@
+#include "../../grid.h"
+#include "../../random.h"
 #include "../../solver.h"
 
-#include <array>
-#include <bitset>
+#include <algorithm>
 #include <fstream>
-#include <functional>
+#include <limits>
 #include <numeric>
 #include <unordered_map>
 
 namespace Year2015::Day6 {
     using Base = ::Common::Solver<unsigned long>;
 
-    template <size_t width, size_t height> class BitGrid {
-      public:
-        BitGrid &set(size_t x, size_t y, bool value = true) {
-            arr.set(idx(x, y), value);
-            return *this;
-        }
-
-        BitGrid &toggle(size_t x, size_t y) {
-            arr.flip(idx(x, y));
-            return *this;
-        }
-
-        BitGrid &reset(size_t x, size_t y) {
-            arr.reset(idx(x, y));
-            return *this;
-        }
-
-        size_t count() const { return arr.count(); }
-
-      private:
-        size_t idx(size_t x, size_t y) const { return (y * width) + x; }
+    // 1000x1000 lights, with no halo since instructions only ever touch whole rectangles.
+    const size_t GRID_SIZE = 1000;
+    using LightGrid = Common::Grid<uint8_t>;
+    using BrightnessGrid = Common::Grid<uint32_t>;
 
-        static const size_t total = width * height;
-        std::bitset<total> arr;
-    };
+    class Solver : public Base {
+        using Base::Solver;
 
-    template <size_t width, size_t height> class BrightnessGrid {
       public:
-        BrightnessGrid &increase_brightness(size_t x, size_t y, unsigned long change) {
-            const auto i = idx(x, y);
-            brightness[i] = brightness[i] + change;
-            return *this;
-        }
+        // 300 random instructions per scale, over rectangles anywhere on the grid.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr const char *OPCODES[] = {"turn on ", "turn off ", "toggle "};
+
+            auto random = Common::Random{seed};
+            const auto corners = [&]() {
+                const auto a = random.below(GRID_SIZE), b = random.below(GRID_SIZE);
+                return std::pair{std::min(a, b), std::max(a, b)};
+            };
 
-        BrightnessGrid &decrease_brightness(size_t x, size_t y, unsigned long change) {
-            const auto i = idx(x, y);
-            const auto current = brightness[i];
-            brightness[i] = change > current ? 0 : current - change;
-            return *this;
+            auto input = std::string{};
+            for (size_t i = 0; i < 300 * scale; ++i) {
+                const auto [start_x, end_x] = corners();
+                const auto [start_y, end_y] = corners();
+                input += random.pick(OPCODES);
+                input += std::to_string(start_x) + ',' + std::to_string(start_y) + " through " +
+                    std::to_string(end_x) + ',' + std::to_string(end_y) + '\n';
+            }
+            return input;
         }
 
-        unsigned long total_brightness() const { return std::accumulate(brightness.begin(), brightness.end(), 0); }
-
-      private:
-        size_t idx(size_t x, size_t y) const { return (y * width) + x; }
-
-        static const size_t total = width * height;
-        std::array<unsigned long, total> brightness;
-    };
-
-    class Solver : public Base {
-        using Base::Solver;
-
       protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            std::string line;
-
-            auto bitgrid = BitGrid<1000, 1000>{};
-            auto brightness_grid = BrightnessGrid<1000, 1000>{};
-
-            const struct {
-                std::unordered_map<Opcode, std::function<void(decltype(bitgrid) &, size_t x, size_t y)>> part1;
-                std::unordered_map<Opcode, std::function<void(decltype(brightness_grid) &, size_t x, size_t y)>> part2;
-            } executors{
-                std::unordered_map<Opcode, std::function<void(decltype(bitgrid) &, size_t x, size_t y)>>{
-                    {Opcode::on, [](decltype(bitgrid) &grid, size_t x, size_t y) { grid.set(x, y); }},
-                    {Opcode::off, [](decltype(bitgrid) &grid, size_t x, size_t y) { grid.reset(x, y); }},
-                    {Opcode::toggle, [](decltype(bitgrid) &grid, size_t x, size_t y) { grid.toggle(x, y); }}},
-                std::unordered_map<Opcode, std::function<void(decltype(brightness_grid) &, size_t x, size_t y)>>{
-                    {Opcode::on,
-                     [](decltype(brightness_grid) &grid, size_t x, size_t y) { grid.increase_brightness(x, y, 1); }},
-                    {Opcode::off,
-                     [](decltype(brightness_grid) &grid, size_t x, size_t y) { grid.decrease_brightness(x, y, 1); }},
-                    {Opcode::toggle,
-                     [](decltype(brightness_grid) &grid, size_t x, size_t y) { grid.increase_brightness(x, y, 2); }}}};
+        Base::Answers solve(std::istream &input) const override {
+            auto lights = LightGrid{GRID_SIZE, GRID_SIZE, 0};
+            auto brightness = BrightnessGrid{GRID_SIZE, GRID_SIZE, 0};
 
             while (input.good() && input.peek() != std::char_traits<char>::eof()) {
                 const auto instruction = read_instruction(input);
+                const auto &rect = instruction.rect;
+                if (rect.start.x > rect.end.x || rect.start.y > rect.end.y || rect.end.x >= GRID_SIZE ||
+                    rect.end.y >= GRID_SIZE) {
+                    throw Error{"malformed_input"};
+                }
 
-                const struct {
-                    std::function<void(decltype(bitgrid) &, size_t x, size_t y)> part1;
-                    std::function<void(decltype(brightness_grid) &, size_t x, size_t y)> part2;
-                } actions{executors.part1.at(instruction.opcode), executors.part2.at(instruction.opcode)};
-
-                for (size_t y = instruction.rect.start.y; y <= instruction.rect.end.y; ++y) {
-                    for (size_t x = instruction.rect.start.x; x <= instruction.rect.end.x; ++x) {
-                        actions.part1(bitgrid, x, y);
-                        actions.part2(brightness_grid, x, y);
-                    }
+                for (size_t y = rect.start.y; y <= rect.end.y; ++y) {
+                    apply(instruction.opcode, lights.row(y), brightness.row(y), rect.start.x, rect.end.x);
                 }
             }
 
-            return Base::Answers{Base::Answer{"Total lights lit", bitgrid.count()},
-                                 Base::Answer{"Total brightness", brightness_grid.total_brightness()}};
+            auto lit = 0UL, total_brightness = 0UL;
+            for (size_t y = 0; y < GRID_SIZE; ++y) {
+                lit = std::accumulate(lights.row(y), lights.row(y) + GRID_SIZE, lit);
+                total_brightness = std::accumulate(brightness.row(y), brightness.row(y) + GRID_SIZE, total_brightness);
+            }
+
+            return Base::Answers{Base::Answer{"Total lights lit", lit},
+                                 Base::Answer{"Total brightness", total_brightness}};
         }
 
       private:
@@ -122,13 +85,38 @@ namespace Year2015::Day6 {
 
         static const std::unordered_map<std::string, Opcode> INSTRUCTION_STRING_MAP;
 
-        static Instruction read_instruction(std::ifstream &input) {
+        // Columns from..to (inclusive) of one row of each grid. The opcode is switched on once, leaving loops that
+        // vectorise.
+        static void apply(Opcode opcode, uint8_t *lights, uint32_t *brightness, size_t from, size_t to) {
+            switch (opcode) {
+            case Opcode::on:
+                for (size_t x = from; x <= to; ++x) {
+                    lights[x] = 1;
+                    brightness[x] += 1;
+                }
+                break;
+            case Opcode::off:
+                for (size_t x = from; x <= to; ++x) {
+                    lights[x] = 0;
+                    brightness[x] -= brightness[x] > 0;
+                }
+                break;
+            case Opcode::toggle:
+                for (size_t x = from; x <= to; ++x) {
+                    lights[x] ^= 1;
+                    brightness[x] += 2;
+                }
+                break;
+            }
+        }
+
+        static Instruction read_instruction(std::istream &input) {
             const auto instruction = Instruction{read_opcode(input), read_rect(input)};
             input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             return instruction;
         }
 
-        static Opcode read_opcode(std::ifstream &input) {
+        static Opcode read_opcode(std::istream &input) {
             std::string instruction;
             if (!(input >> instruction)) {
                 throw Error{"malformed_input"};
@@ -142,7 +130,7 @@ namespace Year2015::Day6 {
             return INSTRUCTION_STRING_MAP.at(instruction);
         }
 
-        static Rect read_rect(std::ifstream &input) {
+        static Rect read_rect(std::istream &input) {
             std::string throwaway_str;
             char throwaway_char;
 
@@ -159,9 +147,10 @@ namespace Year2015::Day6 {
         std::unordered_map<std::string, Opcode>{{"on", Opcode::on}, {"off", Opcode::off}, {"toggle", Opcode::toggle}};
 } // namespace Year2015::Day6
 
+static const auto registration = Common::Registration<Year2015::Day6::Solver>{2015, 6, std::chrono::milliseconds{10}};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2015::Day6::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -1,11 +1,19 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
 #include <algorithm>
-#include <fstream>
+#include <array>
+#include <cctype>
+#include <cstdint>
 #include <functional>
-#include <sstream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace Year2015::Day7 {
     using Base = ::Common::Solver<long>;
@@ -34,26 +42,91 @@ namespace Year2015::Day7 {
         // A wire's value can be either a raw value, another wire identifier or the result of a unary/binary op.
         using WireValue = std::variant<signal_value_t, wire_identifier_t, UnaryOperation, BinaryOperation>;
         using WireValueMap = std::unordered_map<wire_identifier_t, WireValue>;
+        // Rebuilt for each part, from the solve's arena.
+        using MemoizedSignals = std::pmr::unordered_map<wire_identifier_t, signal_value_t>;
+
+      public:
+        // 340 wires per scale in a random order: a few signals (one of them "b"), then gates over randomly picked
+        // earlier wires, ending in "a". Picking uniformly among all earlier wires keeps the longest chain, & so
+        // get_value_for()'s recursion, logarithmic in the number of wires.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr const char *GATES[] = {" AND ", " OR "};
+            static constexpr const char *SHIFTS[] = {" LSHIFT ", " RSHIFT "};
+
+            auto random = Common::Random{seed};
+            const auto wire_count = 340 * scale;
+            // Bijective base 26 from "c" on, leaving "a" & "b" for the wires the puzzle names.
+            const auto name = [&](size_t wire) {
+                if (wire == 0) {
+                    return std::string{"b"};
+                }
+                if (wire == wire_count - 1) {
+                    return std::string{"a"};
+                }
+                auto out = std::string{};
+                for (auto n = wire + 2; n > 0; n = (n - 1) / 26) {
+                    out.insert(out.begin(), static_cast<char>('a' + (n - 1) % 26));
+                }
+                return out;
+            };
+            const auto earlier = [&](size_t wire) { return name(random.below(wire)); };
+
+            const auto signals = std::max<size_t>(2, wire_count / 50);
+            auto lines = std::vector<std::string>{};
+            lines.reserve(wire_count);
+            for (size_t wire = 0; wire < wire_count; ++wire) {
+                auto line = std::string{};
+                if (wire < signals) {
+                    line = std::to_string(random.below(65536));
+                } else {
+                    switch (random.below(4)) {
+                    case 0:
+                        line = "NOT " + earlier(wire);
+                        break;
+                    case 1:
+                        line = earlier(wire) + random.pick(GATES) + earlier(wire);
+                        break;
+                    case 2:
+                        line = earlier(wire) + random.pick(SHIFTS) + std::to_string(random.between(1, 15));
+                        break;
+                    default:
+                        line = random.chance(1, 2) ? earlier(wire) : "1 AND " + earlier(wire);
+                        break;
+                    }
+                }
+                lines.emplace_back(line + " -> " + name(wire) + '\n');
+            }
 
-      protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            auto wires = WireValueMap{};
-
-            for (std::string line; std::getline(input, line);) {
-                const auto parsed = parse_line(line);
-                wires[parsed.wire_identifier] = parsed.wire_value;
+            for (size_t i = lines.size(); i > 1; --i) {
+                std::swap(lines[i - 1], lines[random.below(i)]);
+            }
+            auto input = std::string{};
+            for (const auto &line : lines) {
+                input += line;
             }
+            return input;
+        }
+
+      protected:
+        Base::Answers solve(std::istream &input) const override {
+            auto wires = parse_or_load(input, read_netlist).wires;
 
             struct {
                 signal_value_t part1, part2;
             } answers{};
 
-            auto memoized_signals = std::unordered_map<wire_identifier_t, signal_value_t>{};
-            answers.part1 = get_value_for(wires, memoized_signals, "a");
+            auto memoized_signals = MemoizedSignals{arena()};
+            {
+                const auto timer = time_phase("part 1");
+                answers.part1 = get_value_for(wires, memoized_signals, "a");
+            }
 
-            memoized_signals.clear();
-            wires["b"] = answers.part1;
-            answers.part2 = get_value_for(wires, memoized_signals, "a");
+            {
+                const auto timer = time_phase("part 2");
+                memoized_signals.clear();
+                wires["b"] = answers.part1;
+                answers.part2 = get_value_for(wires, memoized_signals, "a");
+            }
 
             return Base::Answers{
                 Base::Answer{"Wire \"a\" value", answers.part1},
@@ -62,76 +135,168 @@ namespace Year2015::Day7 {
         }
 
       private:
-        using ParsedLine = struct {
-            wire_identifier_t wire_identifier;
-            WireValue wire_value;
-        };
-
-        static ParsedLine parse_line(const std::string &line) {
-            auto sstream = std::istringstream(line);
-
-            std::string throwaway, wire_identifier;
+        struct Netlist {
+            WireValueMap wires;
+
+            // Per wire: its identifier, then the WireValue's alternative index (u8) & that alternative. Operators are
+            // their enum values & operands an index (u8) & a wire identifier or value.
+            void write_snapshot(Common::SnapshotWriter &writer) const {
+                writer.put(uint64_t{wires.size()});
+                for (const auto &[identifier, value] : wires) {
+                    writer.put(std::string_view{identifier});
+                    writer.put(static_cast<uint8_t>(value.index()));
+                    if (const auto *const signal = std::get_if<signal_value_t>(&value)) {
+                        writer.put(*signal);
+                    } else if (const auto *const wire = std::get_if<wire_identifier_t>(&value)) {
+                        writer.put(std::string_view{*wire});
+                    } else if (const auto *const unary = std::get_if<UnaryOperation>(&value)) {
+                        writer.put(unary->op);
+                        write_operand(unary->operand, writer);
+                    } else {
+                        const auto &binary = std::get<BinaryOperation>(value);
+                        writer.put(binary.op);
+                        write_operand(binary.left_operand, writer);
+                        write_operand(binary.right_operand, writer);
+                    }
+                }
+            }
 
-            // Try longest to shortest to prevent short lines accidentally partially matching longer expected lines.
+            static Netlist read_snapshot(Common::SnapshotReader &reader) {
+                auto out = Netlist{};
+                for (auto count = reader.get_count(1); count > 0; --count) {
+                    auto identifier = wire_identifier_t{reader.get_string()};
+                    switch (reader.get<uint8_t>()) {
+                    case 0:
+                        out.wires[std::move(identifier)] = reader.get<signal_value_t>();
+                        break;
+                    case 1:
+                        out.wires[std::move(identifier)] = wire_identifier_t{reader.get_string()};
+                        break;
+                    case 2: {
+                        const auto op = reader.get<UnaryOperator>();
+                        out.wires[std::move(identifier)] = UnaryOperation{op, read_operand(reader)};
+                        break;
+                    }
+                    case 3: {
+                        const auto op = reader.get<BinaryOperator>();
+                        auto left_operand = read_operand(reader);
+                        out.wires[std::move(identifier)] = BinaryOperation{op, left_operand, read_operand(reader)};
+                        break;
+                    }
+                    default:
+                        throw Error{"malformed_snapshot"};
+                    }
+                }
+                return out;
+            }
 
-            // Try for binary op
-            {
-                std::string left_operand, binary_op, right_operand;
-                if (sstream >> left_operand >> binary_op >> right_operand >> throwaway >> wire_identifier) {
-                    return ParsedLine{wire_identifier,
-                                      BinaryOperation{parse_binary_operator(binary_op),
-                                                      parse_operand(left_operand),
-                                                      parse_operand(right_operand)}};
+            static void write_operand(const operand_t &operand, Common::SnapshotWriter &writer) {
+                writer.put(static_cast<uint8_t>(operand.index()));
+                if (const auto *const wire = std::get_if<wire_identifier_t>(&operand)) {
+                    writer.put(std::string_view{*wire});
+                } else {
+                    writer.put(std::get<signal_value_t>(operand));
                 }
-                sstream.clear();
-                sstream.seekg(0);
             }
 
-            // Try for unary op
-            {
-                std::string unary_op, operand;
-                if (sstream >> unary_op >> operand >> throwaway >> wire_identifier) {
-                    return ParsedLine{wire_identifier,
-                                      UnaryOperation{parse_unary_operator(unary_op), parse_operand(operand)}};
+            static operand_t read_operand(Common::SnapshotReader &reader) {
+                switch (reader.get<uint8_t>()) {
+                case 0:
+                    return operand_t{wire_identifier_t{reader.get_string()}};
+                case 1:
+                    return operand_t{reader.get<signal_value_t>()};
+                default:
+                    throw Error{"malformed_snapshot"};
                 }
-                sstream.clear();
-                sstream.seekg(0);
             }
+        };
 
-            // Try for just number
-            {
-                signal_value_t value;
-                if (sstream >> value >> throwaway >> wire_identifier) {
-                    return ParsedLine{wire_identifier, value};
+        static Netlist read_netlist(std::istream &input) {
+            auto netlist = Netlist{};
+            for (const auto record : Utils::records(input)) {
+                const auto line = Utils::trim(record);
+                if (line.empty()) {
+                    continue;
                 }
-                sstream.clear();
-                sstream.seekg(0);
+                auto parsed = parse_line(line);
+                netlist.wires[std::move(parsed.wire_identifier)] = std::move(parsed.wire_value);
             }
+            return netlist;
+        }
 
-            // Try for just another wire
-            {
-                std::string value;
-                if (sstream >> value >> throwaway >> wire_identifier) {
-                    return ParsedLine{wire_identifier, value};
+        using ParsedLine = struct {
+            wire_identifier_t wire_identifier;
+            WireValue wire_value;
+        };
+
+        // "x AND y -> z", "NOT x -> y" or "x -> y", each operand being a wire or a number.
+        static ParsedLine parse_line(std::string_view line) {
+            auto tokens = std::array<std::string_view, 5>{};
+            auto count = size_t{0};
+            for (size_t start = 0; start < line.size();) {
+                const auto end = std::min(line.find(' ', start), line.size());
+                if (end > start) {
+                    if (count == tokens.size()) {
+                        throw Error{"malformed_error"};
+                    }
+                    tokens[count++] = line.substr(start, end - start);
                 }
+                start = end + 1;
             }
 
-            throw Error{"malformed_error"};
+            if (count < 3 || tokens[count - 2] != "->") {
+                throw Error{"malformed_error"};
+            }
+            auto wire_identifier = wire_identifier_t{tokens[count - 1]};
+
+            switch (count) {
+            case 5:
+                return ParsedLine{std::move(wire_identifier),
+                                  BinaryOperation{parse_binary_operator(tokens[1]),
+                                                  parse_operand(tokens[0]),
+                                                  parse_operand(tokens[2])}};
+            case 4:
+                return ParsedLine{std::move(wire_identifier),
+                                  UnaryOperation{parse_unary_operator(tokens[0]), parse_operand(tokens[1])}};
+            case 3:
+                return ParsedLine{std::move(wire_identifier),
+                                  std::visit([](auto &&operand) { return WireValue{std::move(operand)}; },
+                                             parse_operand(tokens[0]))};
+            default:
+                throw Error{"malformed_error"};
+            }
         }
 
-        static operand_t parse_operand(const std::string &operand) {
+        static operand_t parse_operand(std::string_view operand) {
             if (std::all_of(operand.begin(), operand.end(), [](unsigned char c) { return std::isdigit(c); })) {
-                return operand_t{static_cast<signal_value_t>(std::stoul(operand))};
+                return operand_t{Utils::str_to_int<signal_value_t>(operand)};
             }
 
-            return operand_t{operand};
+            return operand_t{wire_identifier_t{operand}};
         }
 
-        static const std::unordered_map<std::string, BinaryOperator> BINARY_OPERATOR_STRING_MAP;
-        static BinaryOperator parse_binary_operator(const std::string &op) { return BINARY_OPERATOR_STRING_MAP.at(op); }
+        static BinaryOperator parse_binary_operator(std::string_view op) {
+            if (op == "AND") {
+                return BinaryOperator::AND;
+            }
+            if (op == "OR") {
+                return BinaryOperator::OR;
+            }
+            if (op == "LSHIFT") {
+                return BinaryOperator::LSHIFT;
+            }
+            if (op == "RSHIFT") {
+                return BinaryOperator::RSHIFT;
+            }
+            throw Error{"malformed_error"};
+        }
 
-        static const std::unordered_map<std::string, UnaryOperator> UNARY_OPERATOR_STRING_MAP;
-        static UnaryOperator parse_unary_operator(const std::string &op) { return UNARY_OPERATOR_STRING_MAP.at(op); }
+        static UnaryOperator parse_unary_operator(std::string_view op) {
+            if (op == "NOT") {
+                return UnaryOperator::NOT;
+            }
+            throw Error{"malformed_error"};
+        }
 
         static const std::unordered_map<UnaryOperator, std::function<signal_value_t(signal_value_t)>> UNARY_ACTIONS;
         static const std::unordered_map<BinaryOperator, std::function<signal_value_t(signal_value_t, signal_value_t)>>
@@ -139,7 +304,7 @@ namespace Year2015::Day7 {
 
         // Meant to be recursively called to get the value for a wire
         static signal_value_t get_value_for(const WireValueMap &wire_value_map,
-                                            std::unordered_map<wire_identifier_t, signal_value_t> &memoized,
+                                            MemoizedSignals &memoized,
                                             const operand_t &wire_identifier_or_value) {
             // Nothing to do if we get asked for the value of a raw value
             if (std::holds_alternative<signal_value_t>(wire_identifier_or_value)) {
@@ -183,15 +348,6 @@ namespace Year2015::Day7 {
         }
     };
 
-    const std::unordered_map<std::string, Solver::BinaryOperator> Solver::BINARY_OPERATOR_STRING_MAP =
-        std::unordered_map<std::string, BinaryOperator>{{"AND", Solver::BinaryOperator::AND},
-                                                        {"OR", Solver::BinaryOperator::OR},
-                                                        {"LSHIFT", Solver::BinaryOperator::LSHIFT},
-                                                        {"RSHIFT", Solver::BinaryOperator::RSHIFT}};
-
-    const std::unordered_map<std::string, Solver::UnaryOperator> Solver::UNARY_OPERATOR_STRING_MAP =
-        std::unordered_map<std::string, UnaryOperator>{{"NOT", Solver::UnaryOperator::NOT}};
-
     const std::unordered_map<Solver::UnaryOperator, std::function<Solver::signal_value_t(Solver::signal_value_t)>>
         Solver::UNARY_ACTIONS =
             std::unordered_map<Solver::UnaryOperator, std::function<Solver::signal_value_t(Solver::signal_value_t)>>{
@@ -207,9 +363,10 @@ namespace Year2015::Day7 {
                 {BinaryOperator::RSHIFT, [](signal_value_t a, signal_value_t b) { return a >> b; }}};
 } // namespace Year2015::Day7
 
+static const auto registration = Common::Registration<Year2015::Day7::Solver>{2015, 7};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2015::Day7::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -1,7 +1,9 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
-#include <deque>
-#include <numeric>
+#include <array>
+#include <string_view>
 
 namespace Year2021::Day1 {
     using Base = ::Common::Solver<size_t>;
@@ -9,53 +11,68 @@ namespace Year2021::Day1 {
     class Solver : public Base {
         using Base::Solver;
 
-      protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            struct {
-                size_t single_increases;
-                size_t sliding_window_of_3_increases;
-            } result_tracker{0, 0};
+      public:
+        // 2000 depths per scale, wandering mostly downwards like the real sonar sweep.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            auto depth = int64_t{150};
+            for (size_t i = 0; i < 2000 * scale; ++i) {
+                depth = std::max(int64_t{1}, depth + random.between(-8, 10));
+                input += std::to_string(depth) + '\n';
+            }
+            return input;
+        }
 
-            unsigned long last = 0;
-            unsigned long current = 0;
+        // One depth per line; only the last three are needed for either part.
+        struct DepthFold {
+            size_t single_increases = 0;
+            size_t sliding_window_of_3_increases = 0;
+            size_t count = 0;
+            std::array<unsigned long, 3> last_three{};
 
-            auto last_two_window_numbers = std::deque<unsigned long>{};
+            void add(std::string_view line) {
+                line = Utils::trim(line);
+                if (line.empty()) {
+                    return;
+                }
+                const auto current = Utils::str_to_int<unsigned long>(line);
 
-            size_t i = 0;
-            while (++i, input >> current) {
                 // Part 1
-                if (i > 1 && current > last) {
-                    ++result_tracker.single_increases;
+                if (count > 0 && current > last_three[(count - 1) % 3]) {
+                    ++single_increases;
                 }
-                last = current;
 
-                // Part 2
-                last_two_window_numbers.emplace_back(current);
+                // Part 2: neighbouring windows share two depths, so the later one is larger if its new depth is
+                // larger than the one the earlier window started with.
+                if (count >= 3 && current > last_three[count % 3]) {
+                    ++sliding_window_of_3_increases;
+                }
 
-                // Do we have enough to have 2 sliding windows?
-                if (last_two_window_numbers.size() == 4) {
-                    // If sum of last 3 greater than sum of first 3?
-                    if (std::accumulate(last_two_window_numbers.begin() + 1, last_two_window_numbers.end(), 0) >
-                        std::accumulate(last_two_window_numbers.begin(), last_two_window_numbers.begin() + 3, 0)) {
-                        ++result_tracker.sliding_window_of_3_increases;
-                    }
+                last_three[count % 3] = current;
+                ++count;
+            }
 
-                    // Always just keep the queue at length 3 or under.
-                    last_two_window_numbers.pop_front();
-                }
+            Base::Answers answers() const {
+                return Base::Answers{
+                    Base::Answer{"Number of measurements larger than previous", single_increases},
+                    Base::Answer{"Number of 3-size sliding window measurements larger than previous",
+                                 sliding_window_of_3_increases}};
             }
+        };
+        using Incremental = Common::RecordFoldSolver<size_t, DepthFold>;
 
-            return Base::Answers{
-                Base::Answer{"Number of measurements larger than previous", result_tracker.single_increases},
-                Base::Answer{"Number of 3-size sliding window measurements larger than previous",
-                             result_tracker.sliding_window_of_3_increases}};
-        }
+      protected:
+        InputMode input_mode() const override { return InputMode::mapped; }
+
+        Base::Answers solve_mapped(std::string_view input) const override { return Incremental{}.solve(input); }
     };
 } // namespace Year2021::Day1
 
+static const auto registration = Common::Registration<Year2021::Day1::Solver>{2021, 1};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day1::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
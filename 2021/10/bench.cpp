@@ -0,0 +1,48 @@
+#include "main.cpp"
+
+#include "../../bench.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Year2021::Day10 {
+    struct Bench {
+        // A final line longer than a chunk, with no newline after it, must come out whole (& not be rejected), as
+        // solve() caps no line's length.
+        static constexpr bool splits_long_last_record() {
+            const auto input = std::string{"()\n"} + std::string(5200, '(');
+            const auto view = std::string_view{input};
+            auto records = Common::RecordSplitter{};
+            auto sizes = std::vector<size_t>{};
+            const auto record_size = [&](std::string_view record) { sizes.emplace_back(record.size()); };
+            for (size_t start = 0; start < view.size(); start += 64) {
+                records.feed(view.substr(start, 64), record_size);
+            }
+            records.finish(record_size);
+            return sizes == std::vector<size_t>{2, 5200};
+        }
+
+        // A generated input fed to the incremental solver in read(2) sized chunks, as --stream would.
+        static Common::Microbenchmark feed_lines() {
+            static constexpr size_t SCALE = 10;
+            static constexpr size_t CHUNK_SIZE = 1 << 16;
+
+            const auto input = Solver::generate_input(SCALE, 1);
+            const auto lines = static_cast<size_t>(std::count(input.begin(), input.end(), '\n'));
+            return Common::Microbenchmark{"feed_lines", lines, input.size(), [input]() {
+                                              auto incremental = Solver::Incremental{};
+                                              const auto view = std::string_view{input};
+                                              for (size_t start = 0; start < view.size(); start += CHUNK_SIZE) {
+                                                  incremental.feed(view.substr(start, CHUNK_SIZE));
+                                              }
+                                              Common::do_not_optimize(incremental.finish());
+                                          }};
+        }
+    };
+
+    static_assert(Bench::splits_long_last_record());
+} // namespace Year2021::Day10
+
+int main(int argc, char **argv) { return Common::bench_main(argc, argv, {Year2021::Day10::Bench::feed_lines()}); }
@@ -1,9 +1,14 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
+#include <algorithm>
 #include <deque>
+#include <functional>
 #include <numeric>
-#include <unordered_map>
-#include <unordered_set>
+#include <queue>
+#include <string_view>
+#include <vector>
 
 namespace Year2021::Day10 {
     using Base = ::Common::Solver<unsigned long long>;
@@ -13,14 +18,86 @@ namespace Year2021::Day10 {
     class Solver : public Base {
         using Base::Solver;
 
-        Answers solve(std::ifstream &input) const override {
-            auto opening_characters = std::deque<char>{};
+        static constexpr auto VALID_CHARS = Utils::CharTable<bool>{")(][}{><"};
+        static constexpr auto STARTING_CHARS = Utils::CharTable<bool>{"([{<"};
+        static constexpr auto CLOSING_CHAR_TO_STARTING_CHAR_MAP =
+            Utils::CharTable<char>{{')', '('}, {']', '['}, {'}', '{'}, {'>', '<'}};
+        static constexpr auto FIRST_ILLEGAL_CLOSING_CHAR_TO_SCORE =
+            Utils::CharTable<unsigned>{{')', 3}, {']', 57}, {'}', 1197}, {'>', 25137}};
+        static constexpr auto LEFT_OVER_STARTING_CHAR_TO_SCORE =
+            Utils::CharTable<unsigned>{{'(', 1}, {'[', 2}, {'{', 3}, {'<', 4}};
+
+      public:
+        // 110 lines per scale, about half of them corrupted & the rest incomplete.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr char OPENING[] = {'(', '[', '{', '<'};
+            static constexpr char CLOSING[] = {')', ']', '}', '>'};
+
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            auto open = std::vector<size_t>{};
+            for (size_t line = 0; line < 110 * scale; ++line) {
+                const auto length = static_cast<size_t>(random.between(90, 110));
+                const auto corrupt_at = random.chance(1, 2) ? static_cast<size_t>(random.between(10, 89)) : length;
+
+                open.clear();
+                for (size_t i = 0; i < length; ++i) {
+                    if (i >= corrupt_at && !open.empty()) {
+                        input += CLOSING[(open.back() + static_cast<size_t>(random.between(1, 3))) % 4];
+                        break;
+                    }
+
+                    // Capped so completion scores fit in 64 bits.
+                    if (open.empty() || (open.size() < 20 && random.chance(11, 20))) {
+                        open.emplace_back(random.below(4));
+                        input += OPENING[open.back()];
+                    } else {
+                        input += CLOSING[open.back()];
+                        open.pop_back();
+                    }
+                }
+
+                if (corrupt_at == length && open.empty()) {
+                    input += '(';
+                }
+                input += '\n';
+            }
+            return input;
+        }
+
+        // Lines are scored on their own. Only the completion scores are kept, split into the lower & upper halves so
+        // that their median is always at the top of one of them: memory grows with the number of incomplete lines
+        // rather than with the input, & answers() doesn't have to look through them.
+        struct LineFold {
+            unsigned long long syntax_error_score_for_corrupt_lines = 0;
+            // Holds the middle score when there's an odd number of them.
+            std::priority_queue<unsigned long long> lower_completion_scores;
+            std::priority_queue<unsigned long long, std::vector<unsigned long long>, std::greater<>>
+                upper_completion_scores;
+            std::deque<char> opening_characters;
+
+            void add_completion_score(unsigned long long score) {
+                if (lower_completion_scores.empty() || score <= lower_completion_scores.top()) {
+                    lower_completion_scores.push(score);
+                } else {
+                    upper_completion_scores.push(score);
+                }
+
+                if (lower_completion_scores.size() > upper_completion_scores.size() + 1) {
+                    upper_completion_scores.push(lower_completion_scores.top());
+                    lower_completion_scores.pop();
+                } else if (upper_completion_scores.size() > lower_completion_scores.size()) {
+                    lower_completion_scores.push(upper_completion_scores.top());
+                    upper_completion_scores.pop();
+                }
+            }
 
-            auto syntax_error_score_for_corrupt_lines = (unsigned long long){0};
-            auto completion_score = std::vector<unsigned long long>{};
+            void add(std::string_view record) {
+                const auto line = Utils::trim(record);
+                if (line.empty()) {
+                    return;
+                }
 
-            auto line = std::string{};
-            while (input >> line) {
                 for (const auto c : line) {
                     if (!VALID_CHARS.contains(c)) {
                         throw Error{"disallowed_character"};
@@ -50,7 +127,7 @@ namespace Year2021::Day10 {
 
                 if (!opening_characters.empty()) {
                     // incomplete line
-                    completion_score.emplace_back(std::accumulate(
+                    add_completion_score(std::accumulate(
                         opening_characters.begin(),
                         opening_characters.end(),
                         (unsigned long long)0,
@@ -60,42 +137,31 @@ namespace Year2021::Day10 {
                 opening_characters.clear();
             }
 
-            // Sort enough to get median
-            std::nth_element(completion_score.begin(),
-                             completion_score.begin() + (completion_score.size() / 2),
-                             completion_score.end());
-            const auto median = completion_score[completion_score.size() / 2];
+            Answers answers() const {
+                // The higher of the two middle scores when there's an even number of them.
+                auto median = (unsigned long long){0};
+                if (lower_completion_scores.size() > upper_completion_scores.size()) {
+                    median = lower_completion_scores.top();
+                } else if (!upper_completion_scores.empty()) {
+                    median = upper_completion_scores.top();
+                }
 
-            return Answers{Answer{"Total syntax error score for first illegal character for corrupt lines",
-                                  syntax_error_score_for_corrupt_lines},
-                           Answer{"Middle completion score", median}};
-        }
+                return Answers{Answer{"Total syntax error score for first illegal character for corrupt lines",
+                                      syntax_error_score_for_corrupt_lines},
+                               Answer{"Middle completion score", median}};
+            }
+        };
+        using Incremental = Common::RecordFoldSolver<unsigned long long, LineFold>;
 
-        static const std::unordered_set<char> VALID_CHARS;
-        static const std::unordered_set<char> STARTING_CHARS;
-        static const std::unordered_map<char, char> CLOSING_CHAR_TO_STARTING_CHAR_MAP;
-        static const std::unordered_map<char, unsigned> FIRST_ILLEGAL_CLOSING_CHAR_TO_SCORE;
-        static const std::unordered_map<char, unsigned> LEFT_OVER_STARTING_CHAR_TO_SCORE;
+      protected:
+        Answers solve(std::istream &input) const override { return Incremental{}.solve(input); }
     };
-
-    const std::unordered_set<char> Solver::VALID_CHARS =
-        std::unordered_set<char>{')', '(', ']', '[', '}', '{', '>', '<'};
-
-    const std::unordered_set<char> Solver::STARTING_CHARS = std::unordered_set<char>{'(', '[', '{', '<'};
-
-    const std::unordered_map<char, char> Solver::CLOSING_CHAR_TO_STARTING_CHAR_MAP =
-        std::unordered_map<char, char>{{')', '('}, {']', '['}, {'}', '{'}, {'>', '<'}};
-
-    const std::unordered_map<char, unsigned> Solver::FIRST_ILLEGAL_CLOSING_CHAR_TO_SCORE =
-        std::unordered_map<char, unsigned>{{')', 3}, {']', 57}, {'}', 1197}, {'>', 25137}};
-
-    const std::unordered_map<char, unsigned> Solver::LEFT_OVER_STARTING_CHAR_TO_SCORE =
-        std::unordered_map<char, unsigned>{{'(', 1}, {'[', 2}, {'{', 3}, {'<', 4}};
 } // namespace Year2021::Day10
 
+static const auto registration = Common::Registration<Year2021::Day10::Solver>{2021, 10};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day10::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
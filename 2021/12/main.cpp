@@ -1,10 +1,13 @@
+#include "../../random.h"
 #include "../../solver.h"
 
+#include <algorithm>
+#include <memory_resource>
+#include <string_view>
 #include <unordered_map>
 
 namespace Year2021::Day12 {
     using std::string;
-    using std::unordered_map;
     using std::vector;
 
     using Base = ::Common::Solver<unsigned long long>;
@@ -14,11 +17,70 @@ namespace Year2021::Day12 {
     class Solver : public Base {
         using Base::Solver;
 
-        Answers solve(std::ifstream &input) const override {
-            const auto graph = read_and_construct_graph(input);
+      public:
+        // One random cave system per scale, each of 6 small & 3 big caves (big ones only ever next to small ones, or
+        // paths would never end) joined to start & end. Paths can't cross from one system to another without revisiting
+        // start, so the path counts, & the time to find them, grow linearly with scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr size_t SMALL_CAVES = 6, BIG_CAVES = 3;
+
+            auto random = Common::Random{seed};
+            // Bijective base 26 in letters from `a` (or `A`) on, after a "c" (or "C") so that none is "start" or "end".
+            const auto name = [](char a, size_t n) {
+                auto out = string{};
+                for (++n; n > 0; n = (n - 1) / 26) {
+                    out.insert(out.begin(), static_cast<char>(a + (n - 1) % 26));
+                }
+                return static_cast<char>(a + 'c' - 'a') + out;
+            };
+
+            auto edges = vector<string>{};
+            for (size_t system = 0; system < scale; ++system) {
+                const auto small = [&](size_t i) { return name('a', system * SMALL_CAVES + i); };
+                const auto big = [&](size_t i) { return name('A', system * BIG_CAVES + i); };
+
+                for (size_t i = 0; i < SMALL_CAVES; ++i) {
+                    for (size_t j = i + 1; j < SMALL_CAVES; ++j) {
+                        if (random.chance(1, 4)) {
+                            edges.emplace_back(small(i) + '-' + small(j));
+                        }
+                    }
+                    for (size_t j = 0; j < BIG_CAVES; ++j) {
+                        if (random.chance(1, 2)) {
+                            edges.emplace_back(big(j) + '-' + small(i));
+                        }
+                    }
+                }
+                edges.emplace_back("start-" + small(0));
+                edges.emplace_back("start-" + big(0));
+                edges.emplace_back(small(SMALL_CAVES - 1) + "-end");
+                edges.emplace_back(big(BIG_CAVES - 1) + "-end");
+            }
 
-            return Answers{Answer{"Paths that only visit small caves at most once", total_path_count<false>(graph)},
-                           Answer{"Paths that can visit one small cave twice", total_path_count<true>(graph)}};
+            for (size_t i = edges.size(); i > 1; --i) {
+                std::swap(edges[i - 1], edges[random.below(i)]);
+            }
+            auto input = string{};
+            for (const auto &edge : edges) {
+                input += edge + '\n';
+            }
+            return input;
+        }
+
+      private:
+        Answers solve(std::istream &input) const override {
+            const auto graph = [&]() {
+                const auto timer = time_phase("parse");
+                return read_and_construct_graph(input, arena());
+            }();
+
+            return solve_parts(
+                [&]() {
+                    return Answer{"Paths that only visit small caves at most once", total_path_count<false>(graph)};
+                },
+                [&]() {
+                    return Answer{"Paths that can visit one small cave twice", total_path_count<true>(graph)};
+                });
         };
 
       private:
@@ -70,23 +132,27 @@ namespace Year2021::Day12 {
             return total_paths;
         }
 
-        static unordered_map<string, vector<string>> read_simple_graph(std::ifstream &input) {
-            auto graph = unordered_map<string, vector<string>>{};
+        // Only needed while building the Graph, so both maps come from the solve's arena.
+        using SimpleGraph = std::pmr::unordered_map<std::pmr::string, std::pmr::vector<std::pmr::string>>;
 
-            const auto add_edge = [&](const std::string &from, const std::string &to) {
+        static SimpleGraph read_simple_graph(std::istream &input, std::pmr::memory_resource *memory) {
+            auto graph = SimpleGraph{memory};
+
+            const auto add_edge = [&](std::string_view from, std::string_view to) {
+                auto &edges = graph[std::pmr::string{from, memory}];
                 if (from == "end" || to == "start") {
-                    graph.emplace(from, vector<string>{});
                     return;
                 }
 
-                graph[from].emplace_back(to);
+                edges.emplace_back(to);
             };
 
             string s;
             while (input >> s) {
-                const auto delim_pos = s.find('-');
-                const auto vertex_0 = s.substr(0, delim_pos);
-                const auto vertex_1 = s.substr(delim_pos + 1);
+                const auto line = std::string_view{s};
+                const auto delim_pos = line.find('-');
+                const auto vertex_0 = line.substr(0, delim_pos);
+                const auto vertex_1 = line.substr(delim_pos + 1);
 
                 add_edge(vertex_0, vertex_1);
                 add_edge(vertex_1, vertex_0);
@@ -95,11 +161,11 @@ namespace Year2021::Day12 {
             return graph;
         }
 
-        static Graph read_and_construct_graph(std::ifstream &input) {
-            const auto simple_graph = read_simple_graph(input);
+        static Graph read_and_construct_graph(std::istream &input, std::pmr::memory_resource *memory) {
+            const auto simple_graph = read_simple_graph(input, memory);
 
             const auto id_map = [&]() {
-                auto out = unordered_map<string, size_t>{};
+                auto out = std::pmr::unordered_map<std::string_view, size_t>{memory};
                 auto i = size_t{0};
                 for (const auto &v : simple_graph) {
                     out[v.first] = i++;
@@ -133,9 +199,10 @@ namespace Year2021::Day12 {
     };
 } // namespace Year2021::Day12
 
+static const auto registration = Common::Registration<Year2021::Day12::Solver>{2021, 12, std::chrono::milliseconds{5}};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day12::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -1,15 +1,17 @@
+#include "../../random.h"
 #include "../../solver.h"
 #include "../../utils.h"
 
 #include <cstring>
+#include <memory_resource>
 #include <numeric>
 #include <sstream>
+#include <string_view>
 #include <unordered_set>
 
 namespace Year2021::Day13 {
     using std::string;
     using std::tuple;
-    using std::unordered_set;
     using std::vector;
 
     using Base = ::Common::Solver<string>;
@@ -19,8 +21,35 @@ namespace Year2021::Day13 {
     class Solver : public Base {
         using Base::Solver;
 
+      public:
+        // 866 random dots per scale on the puzzle's 1311x895 sheet (so denser with scale), then folds through the
+        // middle of each side in turn until it's down to the puzzle's 40x6.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto width = 1311, height = 895;
+
+            auto input = string{};
+            for (size_t i = 0; i < 866 * scale; ++i) {
+                input += std::to_string(random.below(width)) + ',' + std::to_string(random.below(height)) + '\n';
+            }
+
+            input += '\n';
+            while (width > 40 || height > 6) {
+                if (width > 40) {
+                    width /= 2;
+                    input += "fold along x=" + std::to_string(width) + '\n';
+                }
+                if (height > 6) {
+                    height /= 2;
+                    input += "fold along y=" + std::to_string(height) + '\n';
+                }
+            }
+            return input;
+        }
+
+      private:
         struct FoldedDotTracker {
-            struct Hash : public std::unary_function<tuple<int, int>, std::size_t> {
+            struct Hash {
                 std::size_t operator()(const tuple<int, int> &p) const {
                     static_assert(sizeof(std::get<0>(p)) * 2 == sizeof(size_t),
                                   "Point::Hash assumes that x & y can fit into hash key");
@@ -29,12 +58,13 @@ namespace Year2021::Day13 {
                 }
             };
 
-            using dots_set = unordered_set<tuple<int, int>, Hash>;
+            using dots_set = std::pmr::unordered_set<tuple<int, int>, Hash>;
 
             dots_set dots[2];
             size_t next_idx;
 
-            FoldedDotTracker(const vector<tuple<int, int>> &d) : next_idx(1) {
+            FoldedDotTracker(const vector<tuple<int, int>> &d, std::pmr::memory_resource *memory)
+                : dots{dots_set{memory}, dots_set{memory}}, next_idx(1) {
                 std::copy(d.begin(), d.end(), std::inserter(dots[0], dots[0].end()));
             }
 
@@ -58,10 +88,10 @@ namespace Year2021::Day13 {
         // Written with the assumption that we're instructed to fold such that the paper never folds past the left or
         // top edge.
         //
-        Answers solve(std::ifstream &input) const override {
-            const auto [dots, instructions] = read_initial_state_and_instructions(input);
+        Answers solve(std::istream &input) const override {
+            const auto [dots, instructions] = parse_or_load(input, read_initial_state_and_instructions);
 
-            auto tracker = FoldedDotTracker(dots);
+            auto tracker = FoldedDotTracker(dots, arena());
 
             const auto get_folded_value = [](int old_value, int fold_along_value) {
                 if (old_value <= fold_along_value) {
@@ -75,6 +105,7 @@ namespace Year2021::Day13 {
 
             for (size_t i = 0; i < instructions.size(); ++i) {
                 const auto &inst = instructions[i];
+                const auto span = Common::TraceSpan{"fold", i + 1};
 
                 auto &next = tracker.next_dots();
                 next.clear();
@@ -142,32 +173,68 @@ namespace Year2021::Day13 {
         struct DotsAndInstructions {
             vector<tuple<int, int>> dots;
             vector<FoldInstruction> instructions;
+
+            // Dots as x & y pairs, then folds as a direction (0 for x, 1 for y) & value pairs.
+            void write_snapshot(Common::SnapshotWriter &writer) const {
+                auto values = vector<int32_t>{};
+                values.reserve(dots.size() * 2);
+                for (const auto &[x, y] : dots) {
+                    values.insert(values.end(), {x, y});
+                }
+                writer.put_array(values.data(), values.size());
+
+                values.clear();
+                for (const auto &instruction : instructions) {
+                    values.insert(values.end(), {instruction.direction == FoldAlong::x ? 0 : 1, instruction.value});
+                }
+                writer.put_array(values.data(), values.size());
+            }
+
+            static DotsAndInstructions read_snapshot(Common::SnapshotReader &reader) {
+                const auto dot_values = reader.get_array<int32_t>();
+                const auto instruction_values = reader.get_array<int32_t>();
+                if (dot_values.size() % 2 != 0 || instruction_values.size() % 2 != 0) {
+                    throw Error{"malformed_snapshot"};
+                }
+
+                auto out = DotsAndInstructions{};
+                out.dots.reserve(dot_values.size() / 2);
+                for (size_t i = 0; i < dot_values.size(); i += 2) {
+                    out.dots.emplace_back(dot_values[i], dot_values[i + 1]);
+                }
+                out.instructions.reserve(instruction_values.size() / 2);
+                for (size_t i = 0; i < instruction_values.size(); i += 2) {
+                    out.instructions.emplace_back(instruction_values[i] == 0 ? FoldAlong::x : FoldAlong::y,
+                                                  instruction_values[i + 1]);
+                }
+                return out;
+            }
         };
 
-        static DotsAndInstructions read_initial_state_and_instructions(std::ifstream &input) {
+        static DotsAndInstructions read_initial_state_and_instructions(std::istream &input) {
             auto out = DotsAndInstructions{};
 
-            auto line = string{};
-            for (string line; std::getline(input, line);) {
-                const auto line_view = std::string_view{line};
-                const auto fold_line_prefix = line_view.substr(0, FOLD_INSTRUCTION_PREFIX_LENGTH);
+            for (const auto record : Utils::records(input)) {
+                const auto line = Utils::trim(record);
+                const auto fold_line_prefix = line.substr(0, FOLD_INSTRUCTION_PREFIX_LENGTH);
                 if (fold_line_prefix == FOLD_INSTRUCTION_X_PREFIX) {
                     out.instructions.emplace_back(
-                        FoldAlong::x, Utils::str_to_int<int>(line_view.substr(FOLD_INSTRUCTION_PREFIX_LENGTH)));
+                        FoldAlong::x, Utils::str_to_int<int>(line.substr(FOLD_INSTRUCTION_PREFIX_LENGTH)));
                     continue;
                 }
                 if (fold_line_prefix == FOLD_INSTRUCTION_Y_PREFIX) {
                     out.instructions.emplace_back(
-                        FoldAlong::y, Utils::str_to_int<int>(line_view.substr(FOLD_INSTRUCTION_PREFIX_LENGTH)));
+                        FoldAlong::y, Utils::str_to_int<int>(line.substr(FOLD_INSTRUCTION_PREFIX_LENGTH)));
                     continue;
                 }
 
-                auto line_stream = std::istringstream(line);
-                int x, y;
-                char comma;
-                if (line_stream >> x >> comma >> y && comma == ',') {
-                    out.dots.emplace_back(x, y);
+                // Anything else that isn't an "x,y" dot (e.g. the blank line between the sections) is skipped.
+                const auto comma = line.find(',');
+                if (comma == std::string_view::npos || comma == 0) {
+                    continue;
                 }
+                out.dots.emplace_back(Utils::str_to_int<int>(line.substr(0, comma)),
+                                      Utils::str_to_int<int>(line.substr(comma + 1)));
             }
 
             return out;
@@ -178,9 +245,10 @@ namespace Year2021::Day13 {
     const char *const Solver::FOLD_INSTRUCTION_Y_PREFIX = "fold along y=";
 } // namespace Year2021::Day13
 
+static const auto registration = Common::Registration<Year2021::Day13::Solver>{2021, 13};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day13::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
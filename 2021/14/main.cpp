@@ -1,150 +1,196 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
-#include <numeric>
-#include <unordered_map>
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
 
-namespace Year2021::Day14 {
-    using std::string;
-    using std::unordered_map;
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
 
+namespace Year2021::Day14 {
     using Base = ::Common::Solver<size_t>;
     using Answers = Base::Answers;
     using Answer = Base::Answer;
 
+    // Elements are the letters A-Z, so that pairs of them can index flat arrays.
+    constexpr size_t ELEMENTS = 26;
+    constexpr size_t PAIRS = ELEMENTS * ELEMENTS;
+
     class Solver : public Base {
         using Base::Solver;
 
-        // Bits 15-8 represent first character
-        // Bits 7-0 represent second character
-        using EncodedCharacterPair = uint16_t;
-
-        Answers solve(std::ifstream &input) const override {
-            const auto [polymer_template, initial_pairs, insertion_rules] =
-                read_encoded_template_pairs_and_rules(input);
-
-            auto results = unordered_map<size_t, MinMaxOccurenceSnapshot>{{10, {}}, {40, {}}};
+      public:
+        // Like the puzzle's: 10 random elements, a rule for each of their 100 pairs & a template of them, 20 elements
+        // long per scale. Only reading the template grows with scale, as polymerising works on pair counts.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr size_t USED_ELEMENTS = 10;
 
-            auto char_frequency = unordered_map<char, size_t>{};
-            for (char c : polymer_template) {
-                ++char_frequency[c];
+            auto random = Common::Random{seed};
+            auto letters = std::string{"ABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+            for (size_t i = 0; i < USED_ELEMENTS; ++i) {
+                std::swap(letters[i], letters[i + random.below(letters.size() - i)]);
             }
+            const auto element = [&]() { return letters[random.below(USED_ELEMENTS)]; };
 
-            auto current = initial_pairs;
-            auto scratch = initial_pairs;
-
-            for (size_t step = 0; step < 40; ++step) {
-                for (const auto &pair_count : current) {
-                    const auto &rule = insertion_rules.find(pair_count.first);
-                    if (rule != insertion_rules.end()) {
-                        const char mid_char = rule->second;
-                        const auto count = pair_count.second;
-                        const auto encoded_pair = pair_count.first;
-
-                        // Add the two new pairs created when we insert the rule char in the middle.
-                        scratch[encode_character_pair(decode_char<0>(encoded_pair), mid_char)] += count;
-                        scratch[encode_character_pair(mid_char, decode_char<1>(encoded_pair))] += count;
-
-                        // The original count pairs are gone now since we've eliminated them by adding a char in the
-                        // middle.
-                        scratch[encoded_pair] -= count;
-
-                        // We added count new mid_char's.
-                        char_frequency[mid_char] += count;
-                    }
+            auto input = std::string{};
+            for (size_t i = 0; i < 20 * scale; ++i) {
+                input += element();
+            }
+            input += "\n\n";
+            for (size_t first = 0; first < USED_ELEMENTS; ++first) {
+                for (size_t second = 0; second < USED_ELEMENTS; ++second) {
+                    input += std::string{letters[first], letters[second]} + " -> " + element() + '\n';
                 }
+            }
+            return input;
+        }
 
-                // Done with this iteration; make scratch the new current.
-                current = scratch;
+      protected:
+        InputMode input_mode() const override { return InputMode::mapped; }
 
-                // If we're supposed to record occurences here, take a snapshot.
-                if (results.contains(step + 1)) {
-                    results[step + 1] = take_min_max_occurence_snapshot(char_frequency);
-                }
-            }
+        Answers solve_mapped(std::string_view input) const override { return to_answers(polymerise(input)); }
 
-            return Answers{Answer{"Difference of most common & least common element (after step 10)",
-                                  results.at(10).max_occurences - results.at(10).min_occurences},
-                           Answer{"Difference of most common & least common element (after step 40)",
-                                  results.at(40).max_occurences - results.at(40).min_occurences}};
+      private:
+        using ElementFrequency = std::array<size_t, ELEMENTS>;
+        // Indexed by first element * ELEMENTS + second element.
+        using PairCounts = std::array<size_t, PAIRS>;
+        // The element inserted between each pair, or NO_RULE.
+        using InsertionRules = std::array<uint8_t, PAIRS>;
+
+        static constexpr uint8_t NO_RULE = ELEMENTS;
+
+        struct Polymer {
+            ElementFrequency frequency;
+            PairCounts pairs;
+            InsertionRules rules;
         };
 
-      private:
-        struct MinMaxOccurenceSnapshot {
-            size_t max_occurences;
-            size_t min_occurences;
+        struct Differences {
+            size_t after_10_steps;
+            size_t after_40_steps;
         };
 
-        static MinMaxOccurenceSnapshot take_min_max_occurence_snapshot(const unordered_map<char, size_t> &frequency) {
-            return MinMaxOccurenceSnapshot{
-                std::accumulate(frequency.begin(),
-                                frequency.end(),
-                                size_t{0},
-                                [](size_t acc, const auto &f) { return acc > f.second ? acc : f.second; }),
-                std::accumulate(frequency.begin(),
-                                frequency.end(),
-                                size_t{std::numeric_limits<size_t>::max()},
-                                [](size_t acc, const auto &f) { return acc < f.second ? acc : f.second; })};
+        static Answers to_answers(const Differences &differences) {
+            return Answers{Answer{"Difference of most common & least common element (after step 10)",
+                                  differences.after_10_steps},
+                           Answer{"Difference of most common & least common element (after step 40)",
+                                  differences.after_40_steps}};
         }
 
-        struct PolymerTemplateAndRulesEncoded {
-            string polymer_template;
-            unordered_map<EncodedCharacterPair, size_t> pairs;
-            unordered_map<EncodedCharacterPair, char> pair_insertion_rules;
-        };
+        // Allocation-free, so that it can also run at compile time on an embedded input.
+        static constexpr Differences polymerise(std::string_view input) {
+            auto polymer = read_polymer(input);
+            auto differences = Differences{};
 
-        static EncodedCharacterPair encode_character_pair(char a, char b) { return (a << 8) | b; }
+            // Traced in blocks of 10 steps, each ending where a snapshot could be taken.
+            for (size_t steps = 10; steps <= 40; steps += 10) {
+                const auto span = Common::TraceSpan{"steps to", steps};
+                for (size_t step = 0; step < 10; ++step) {
+                    grow(polymer);
+                }
 
-        template <size_t idx> static char decode_char(EncodedCharacterPair v) {
-            if (idx == 0) {
-                return (v >> 8) & 0xFF;
+                if (steps == 10) {
+                    differences.after_10_steps = most_minus_least_common(polymer.frequency);
+                }
             }
-            return v & 0xFF;
-        }
+            differences.after_40_steps = most_minus_least_common(polymer.frequency);
 
-        static PolymerTemplateAndRulesEncoded read_encoded_template_pairs_and_rules(std::ifstream &input) {
-            const auto [polymer_template, insertion_rules] = read_polymer_template_and_rules(input);
+            return differences;
+        }
 
-            auto out = PolymerTemplateAndRulesEncoded{polymer_template, {}, {}};
-            if (polymer_template.size() >= 2) {
-                for (size_t i = 1; i < polymer_template.size(); ++i) {
-                    ++out.pairs[encode_character_pair(polymer_template[i - 1], polymer_template[i])];
+        static constexpr void grow(Polymer &polymer) {
+            auto next = PairCounts{};
+            for (size_t pair = 0; pair < PAIRS; ++pair) {
+                const auto count = polymer.pairs[pair];
+                const auto mid = polymer.rules[pair];
+                if (count == 0 || mid == NO_RULE) {
+                    next[pair] += count;
+                    continue;
                 }
+
+                // Inserting mid replaces the pair with the two pairs either side of it.
+                next[pair / ELEMENTS * ELEMENTS + mid] += count;
+                next[mid * ELEMENTS + pair % ELEMENTS] += count;
+                polymer.frequency[mid] += count;
             }
+            polymer.pairs = next;
+        }
 
-            for (const auto &rule : insertion_rules) {
-                out.pair_insertion_rules.emplace(encode_character_pair(rule.first[0], rule.first[1]), rule.second);
+        // Of the elements that occur at all.
+        static constexpr size_t most_minus_least_common(const ElementFrequency &frequency) {
+            auto most = size_t{0}, least = std::numeric_limits<size_t>::max();
+            for (const auto count : frequency) {
+                if (count > 0) {
+                    most = count > most ? count : most;
+                    least = count < least ? count : least;
+                }
             }
+            return most - least;
+        }
 
-            return out;
+        static constexpr uint8_t element(char c) {
+            if (c < 'A' || c > 'Z') {
+                throw Error{"malformed_input"};
+            }
+            return static_cast<uint8_t>(c - 'A');
         }
 
-        struct PolymerTemplateAndRules {
-            string polymer_template;
-            unordered_map<string, char> pair_insertion_rules;
-        };
+        static constexpr size_t pair(char a, char b) { return element(a) * ELEMENTS + element(b); }
 
-        static PolymerTemplateAndRules read_polymer_template_and_rules(std::ifstream &input) {
-            auto out = PolymerTemplateAndRules{};
+        // The template on the first line, then rules like "CH -> B" one per line.
+        static constexpr Polymer read_polymer(std::string_view input) {
+            auto polymer = Polymer{};
+            polymer.rules.fill(NO_RULE);
 
-            if (!(input >> out.polymer_template)) {
+            const auto template_end = input.find('\n');
+            const auto polymer_template = Utils::trim(input.substr(0, template_end));
+            if (polymer_template.empty()) {
                 throw Error{"malformed_input"};
             }
+            for (size_t i = 0; i < polymer_template.size(); ++i) {
+                ++polymer.frequency[element(polymer_template[i])];
+                if (i > 0) {
+                    ++polymer.pairs[pair(polymer_template[i - 1], polymer_template[i])];
+                }
+            }
+
+            auto rest = template_end == std::string_view::npos ? std::string_view{} : input.substr(template_end + 1);
+            while (!rest.empty()) {
+                const auto line_end = rest.find('\n');
+                const auto line = Utils::trim(rest.substr(0, line_end));
+                rest = line_end == std::string_view::npos ? std::string_view{} : rest.substr(line_end + 1);
+                if (line.empty()) {
+                    continue;
+                }
 
-            string pair_match, throwaway;
-            char insertion_char;
-            while ((input >> pair_match >> throwaway >> insertion_char) && throwaway == "->" &&
-                   pair_match.size() == 2) {
-                out.pair_insertion_rules.emplace(pair_match, insertion_char);
+                if (line.size() != 7 || line.substr(2, 4) != " -> ") {
+                    throw Error{"malformed_input"};
+                }
+                polymer.rules[pair(line[0], line[1])] = element(line[6]);
             }
 
-            return out;
+            return polymer;
         }
+
+#ifdef AOC_EMBED_INPUT
+      protected:
+        // After polymerise(), which has to be defined before it can be evaluated.
+        std::optional<Answers> embedded_answers() const override {
+            static constexpr auto EMBEDDED_DIFFERENCES = polymerise(EMBEDDED_INPUT);
+            return to_answers(EMBEDDED_DIFFERENCES);
+        }
+#endif
     };
 } // namespace Year2021::Day14
 
+static const auto registration = Common::Registration<Year2021::Day14::Solver>{2021, 14};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day14::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
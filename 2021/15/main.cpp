@@ -1,6 +1,10 @@
+#include "../../grid.h"
+#include "../../random.h"
 #include "../../solver.h"
 
-#include <numeric>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <queue>
 
 namespace Year2021::Day15 {
@@ -13,183 +17,172 @@ namespace Year2021::Day15 {
     using Answers = Base::Answers;
     using Answer = Base::Answer;
 
-    class Digit5xGrid {
-      public:
-        Digit5xGrid(std::ifstream &input) {
-            std::string s;
-            if (!(input >> s)) {
-                throw std::runtime_error{"malformed_input"};
+    using RiskGrid = Common::Grid<uint8_t>;
+
+    // The input tile & the full map made of 5x5 copies of it, with risks going up by one (wrapping 9 to 1) per tile
+    // to the right or down.
+    struct Digit5xGrid {
+        RiskGrid tile;
+        RiskGrid full;
+
+        explicit Digit5xGrid(RiskGrid input_tile) : tile{std::move(input_tile)} {
+            full = RiskGrid{tile.width() * 5, tile.height() * 5};
+            for (size_t y = 0; y < full.height(); ++y) {
+                const auto *const source = tile.row(y % tile.height());
+                auto *const row = full.row(y);
+                for (size_t x = 0; x < full.width(); ++x) {
+                    const auto value = source[x % tile.width()] + x / tile.width() + y / tile.height();
+                    row[x] = static_cast<uint8_t>((value - 1) % 9 + 1);
+                }
             }
+        }
 
-            auto base_tile = vector<uint8_t>{};
+        Digit5xGrid(RiskGrid tile, RiskGrid full) : tile{std::move(tile)}, full{std::move(full)} {}
 
-            // Assuming all rows are same size
-            tile_w = s.size();
-            parse_row(base_tile, s);
+        static Digit5xGrid parse(std::string_view input) { return Digit5xGrid{RiskGrid::parse_digits(input)}; }
 
-            auto rows = 1;
-            while (input >> s) {
-                parse_row(base_tile, s);
-                ++rows;
-            }
-            tile_h = rows;
-
-            // Make a 5x grid
-            w = tile_w * 5;
-            h = tile_h * 5;
-            grid.resize(w * h);
-
-            for (size_t y = 0; y < h; ++y) {
-                for (size_t x = 0; x < w; ++x) {
-                    // Top-left tile
-                    if (x < tile_w && y < tile_h) {
-                        set(x, y, base_tile[x + y * tile_w]);
-                        continue;
-                    }
+        // Both grids, as the full one takes far longer to build than to copy in.
+        void write_snapshot(Common::SnapshotWriter &writer) const {
+            write_grid(tile, writer);
+            write_grid(full, writer);
+        }
 
-                    // Use tile above
-                    if (x < tile_w) {
-                        const size_t source_y = (y % tile_h) + (tile_h * ((y / tile_h) - 1));
-                        uint8_t value = at(x, source_y) + 1;
-                        value = value > 9 ? 1 : value;
-                        set(x, y, value);
-                        continue;
-                    }
+        static Digit5xGrid read_snapshot(Common::SnapshotReader &reader) {
+            auto tile = read_grid(reader);
+            auto full = read_grid(reader);
+            if (full.width() != tile.width() * 5 || full.height() != tile.height() * 5) {
+                throw std::runtime_error{"malformed_snapshot"};
+            }
+            return Digit5xGrid{std::move(tile), std::move(full)};
+        }
 
-                    // Any other tile we use the source value from left tile
-                    const size_t source_x = (x % tile_w) + (tile_w * ((x / tile_w) - 1));
-                    uint8_t value = at(source_x, y) + 1;
-                    value = value > 9 ? 1 : value;
-                    set(x, y, value);
-                    continue;
-                }
+      private:
+        // Width & then the risks (one byte each) row by row, without the halo.
+        static void write_grid(const RiskGrid &grid, Common::SnapshotWriter &writer) {
+            auto risks = std::string{};
+            risks.reserve(grid.width() * grid.height());
+            for (size_t y = 0; y < grid.height(); ++y) {
+                risks.append(reinterpret_cast<const char *>(grid.row(y)), grid.width());
             }
+            writer.put(uint64_t{grid.width()});
+            writer.put(std::string_view{risks});
         }
 
-        size_t width() const { return w; }
-        size_t height() const { return h; }
-        size_t tile_width() const { return tile_w; }
-        size_t tile_height() const { return tile_h; }
-        uint8_t at(size_t x, size_t y) const { return grid[flat_array_idx(x, y)]; }
-        uint8_t set(size_t x, size_t y, uint8_t value) { return grid[flat_array_idx(x, y)] = value; }
-        size_t flat_array_idx(size_t x, size_t y) const { return x + y * w; }
+        static RiskGrid read_grid(Common::SnapshotReader &reader) {
+            const auto width = reader.get<uint64_t>();
+            const auto risks = reader.get_string();
+            if (width == 0 || risks.empty() || risks.size() % width != 0) {
+                throw std::runtime_error{"malformed_snapshot"};
+            }
 
-      private:
-        size_t w;
-        size_t h;
-        size_t tile_w;
-        size_t tile_h;
-        std::vector<uint8_t> grid;
-
-        static void parse_row(vector<uint8_t> &grid, const std::string &s) {
-            for (auto c : s) {
-                grid.emplace_back(c - '0');
+            auto grid = RiskGrid{width, risks.size() / width};
+            for (size_t y = 0; y < grid.height(); ++y) {
+                std::memcpy(grid.row(y), risks.data() + y * width, width);
             }
+            return grid;
         }
     };
 
     class Solver : public Base {
         using Base::Solver;
 
-        struct Point {
-            size_t x, y;
-        };
-
-        Answers solve(std::ifstream &input) const override {
-            const auto risk_grid = Digit5xGrid{input};
-            if (risk_grid.width() == 0 || risk_grid.height() == 0) {
-                throw Error{"malformed_input"};
+      public:
+        // A square of random 1-9 risks, 100 wide at 1x & with an area growing with scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            const auto side = static_cast<size_t>(std::lround(100 * std::sqrt(static_cast<double>(scale))));
+
+            auto input = string{};
+            for (size_t y = 0; y < side; ++y) {
+                for (size_t x = 0; x < side; ++x) {
+                    input += static_cast<char>('0' + random.between(1, 9));
+                }
+                input += '\n';
             }
+            return input;
+        }
 
-            return Answers{
-                Answer{"Lowest total risk of any path from the top left to the bottom right",
-                       shortest_path_total_distance(risk_grid,
-                                                    Point{},
-                                                    Point{risk_grid.tile_width() - 1, risk_grid.tile_height() - 1},
-                                                    risk_grid.tile_width(),
-                                                    risk_grid.tile_height())},
-                Answer{"Lowest total risk of any path from the top left to the bottom right on 5x grid",
-                       shortest_path_total_distance(risk_grid,
-                                                    Point{},
-                                                    Point{risk_grid.width() - 1, risk_grid.height() - 1},
-                                                    risk_grid.width(),
-                                                    risk_grid.height())}};
-        };
+      protected:
+        InputMode input_mode() const override { return InputMode::mapped; }
+
+        Answers solve_mapped(std::string_view input) const override {
+            const auto risk_grid = parse_or_load(input, Digit5xGrid::parse);
+
+            return solve_parts(
+                [&]() {
+                    return Answer{"Lowest total risk of any path from the top left to the bottom right",
+                                  shortest_path_total_distance(risk_grid.tile)};
+                },
+                [&]() {
+                    return Answer{"Lowest total risk of any path from the top left to the bottom right on 5x grid",
+                                  shortest_path_total_distance(risk_grid.full)};
+                });
+        }
 
       private:
         struct Node {
-            size_t x, y;
+            size_t idx;
             unsigned long long distance;
 
-            Node(size_t x = 0, size_t y = 0, unsigned long long distance = 0) : x(x), y(y), distance(distance) {}
+            Node(size_t idx = 0, unsigned long long distance = 0) : idx(idx), distance(distance) {}
         };
 
-        // Run Djikstra's to find shortest path
-        static unsigned long long shortest_path_total_distance(
-            const Digit5xGrid &distances, Point start, Point destination, size_t width, size_t height) {
-            auto flat_index = [=](size_t x, size_t y) { return x + y * width; };
+        // Run Djikstra's to find shortest path from the top left to the bottom right
+        static unsigned long long shortest_path_total_distance(const RiskGrid &distances) {
+            const auto span = Common::TraceSpan{"dijkstra"};
+            const auto start = distances.index(0, 0);
+            const auto destination = distances.index(distances.width() - 1, distances.height() - 1);
 
-            auto visited = vector<bool>(width * height, false);
-            auto distance_tracker =
-                vector<unsigned long long>(width * height, std::numeric_limits<unsigned long long>::max());
-            distance_tracker[flat_index(start.x, start.y)] = 0;
+            // The halo counts as visited, so neighbours need no bounds checks.
+            auto visited = distances.like<uint8_t>(1);
+            visited.fill(0);
+            auto distance_tracker = distances.like<unsigned long long>(std::numeric_limits<unsigned long long>::max());
+            distance_tracker[start] = 0;
 
-            auto cmp = [](const Node &lhs, const Node &rhs) {
-                return -static_cast<long long>(lhs.distance) < -static_cast<long long>(rhs.distance);
-            };
+            auto cmp = [](const Node &lhs, const Node &rhs) { return lhs.distance > rhs.distance; };
             auto to_visit = priority_queue<Node, std::vector<Node>, decltype(cmp)>(cmp);
-            to_visit.emplace(start.x, start.y, 0);
-
-            auto handle_neighbor = [&](const Node &current, size_t neighbor_x, size_t neighbor_y) {
-                const size_t neighbor_flat_idx = flat_index(neighbor_x, neighbor_y);
-
-                if (neighbor_x >= width || neighbor_y >= height || visited[neighbor_flat_idx]) {
-                    return;
-                }
-
-                const auto distance_through_current = current.distance + distances.at(neighbor_x, neighbor_y);
-                const auto previous_distance = distance_tracker[neighbor_flat_idx];
-                const auto distance = distance_tracker[neighbor_flat_idx] =
-                    std::min(distance_through_current, previous_distance);
-                to_visit.emplace(neighbor_x, neighbor_y, distance);
-            };
+            to_visit.emplace(start, 0);
 
+            const auto neighbours = distances.offsets_4();
             while (!to_visit.empty()) {
                 const auto node = to_visit.top();
                 to_visit.pop();
 
-                const size_t flat_idx = flat_index(node.x, node.y);
-
-                if (visited[flat_idx]) {
+                if (visited[node.idx]) {
                     continue;
                 }
 
-                if (node.x == destination.x && node.y == destination.y) {
+                if (node.idx == destination) {
                     break;
                 }
 
                 // Mark this node visited
-                visited[flat_idx] = true;
+                visited[node.idx] = 1;
 
                 // Compute new distances to our neighbors
-                if (node.x > 0) {
-                    handle_neighbor(node, node.x - 1, node.y); // west
-                }
-                if (node.y > 0) {
-                    handle_neighbor(node, node.x, node.y - 1); // north
+                for (const auto offset : neighbours) {
+                    const auto neighbour = static_cast<size_t>(static_cast<ptrdiff_t>(node.idx) + offset);
+                    if (visited[neighbour]) {
+                        continue;
+                    }
+
+                    const auto distance_through_current = node.distance + distances[neighbour];
+                    if (distance_through_current < distance_tracker[neighbour]) {
+                        distance_tracker[neighbour] = distance_through_current;
+                        to_visit.emplace(neighbour, distance_through_current);
+                    }
                 }
-                handle_neighbor(node, node.x + 1, node.y); // east
-                handle_neighbor(node, node.x, node.y + 1); // south
             }
 
-            return distance_tracker[flat_index(destination.x, destination.y)];
+            return distance_tracker[destination];
         }
     };
 } // namespace Year2021::Day15
 
+static const auto registration = Common::Registration<Year2021::Day15::Solver>{2021, 15, std::chrono::milliseconds{30}};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day15::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
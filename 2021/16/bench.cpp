@@ -0,0 +1,41 @@
+#include "main.cpp"
+
+#include "../../bench.h"
+
+#include <vector>
+
+namespace Year2021::Day16 {
+    struct Bench {
+        // Reads of `bit_count` bits at every offset a packet header or length field could start at, through a random
+        // transmission.
+        template <size_t bit_count> static Common::Microbenchmark read_n_bits_as_integer() {
+            static constexpr size_t BITS = 1 << 16;
+
+            auto random = Common::Random{1};
+            auto bits = vector<bool>(BITS + bit_count);
+            for (size_t i = 0; i < bits.size(); ++i) {
+                bits[i] = random.chance(1, 2);
+            }
+
+            return Common::Microbenchmark{"read_n_bits_as_integer<" + std::to_string(bit_count) + ">",
+                                          BITS,
+                                          BITS / 8,
+                                          [bits = std::move(bits)]() {
+                                              const auto reader = PacketReader{bits};
+                                              for (size_t i = 0; i < BITS; ++i) {
+                                                  Common::do_not_optimize(
+                                                      reader.read_n_bits_as_integer<bit_count>(i).data);
+                                              }
+                                          }};
+        }
+    };
+} // namespace Year2021::Day16
+
+int main(int argc, char **argv) {
+    using Year2021::Day16::Bench;
+    return Common::bench_main(argc,
+                              argv,
+                              {Bench::read_n_bits_as_integer<3>(),
+                               Bench::read_n_bits_as_integer<11>(),
+                               Bench::read_n_bits_as_integer<15>()});
+}
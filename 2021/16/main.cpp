@@ -1,13 +1,15 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
 #include <deque>
+#include <memory_resource>
 #include <numeric>
 #include <unordered_map>
 #include <variant>
 
 namespace Year2021::Day16 {
     using std::array;
-    using std::deque;
     using std::unordered_map;
     using std::vector;
 
@@ -19,22 +21,25 @@ namespace Year2021::Day16 {
       public:
         enum class Type { literal, sum, product, minimum, maximum, greater_than, less_than, equal_to };
 
+        // From the solve's arena (see PacketReader), & only ever moved so that nested packets stay in it.
+        using Packets = std::pmr::vector<Packet>;
+
         Packet(uint8_t version, Packet::Type type, unsigned long long value)
             : version(version), type(type), inner_data(value) {}
 
-        Packet(uint8_t version, Packet::Type type, const vector<Packet> &packets)
-            : version(version), type(type), inner_data(packets) {}
+        Packet(uint8_t version, Packet::Type type, Packets packets)
+            : version(version), type(type), inner_data(std::move(packets)) {}
 
-        unsigned long long sum_of_all_version_numbers() const {
+        unsigned long long sum_of_all_version_numbers(std::pmr::memory_resource *memory) const {
             auto sum = (unsigned long long){};
 
-            auto to_process = deque<const Packet *>{this};
+            auto to_process = std::pmr::deque<const Packet *>{{this}, memory};
             while (!to_process.empty()) {
                 const auto &current_packet = *to_process.front();
                 sum += current_packet.version;
 
-                if (std::holds_alternative<vector<Packet>>(current_packet.inner_data)) {
-                    for (const auto &sub_packet : std::get<vector<Packet>>(current_packet.inner_data)) {
+                if (std::holds_alternative<Packets>(current_packet.inner_data)) {
+                    for (const auto &sub_packet : std::get<Packets>(current_packet.inner_data)) {
                         to_process.emplace_back(&sub_packet);
                     }
                 }
@@ -76,19 +81,21 @@ namespace Year2021::Day16 {
             case Type::equal_to:
                 return sub_packets()[0].evaluate() == sub_packets()[1].evaluate() ? 1 : 0;
             }
+            throw std::runtime_error{"unknown_packet_type"};
         }
 
       private:
-        const vector<Packet> &sub_packets() const { return std::get<vector<Packet>>(inner_data); }
+        const Packets &sub_packets() const { return std::get<Packets>(inner_data); }
 
-        const uint8_t version;
-        const Type type;
-        const std::variant<unsigned long long, vector<Packet>> inner_data;
+        uint8_t version;
+        Type type;
+        std::variant<unsigned long long, Packets> inner_data;
     };
 
     class PacketReader {
       public:
-        PacketReader(const vector<bool> &bits) : bits(bits) {}
+        PacketReader(const vector<bool> &bits, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+            : bits(bits), memory(memory) {}
 
         template <typename T> struct ReadResult {
             T data;
@@ -107,7 +114,10 @@ namespace Year2021::Day16 {
         }
 
       private:
+        friend struct Bench;
+
         const vector<bool> &bits;
+        std::pmr::memory_resource *const memory;
 
         // leading bit indicates whether this is last hex digit (4 bits) or not
         // 0 - last
@@ -134,7 +144,7 @@ namespace Year2021::Day16 {
         }
 
         ReadResult<Packet> read_operator_packet(uint8_t version, Packet::Type type, size_t index) const {
-            auto sub_packets = vector<Packet>{};
+            auto sub_packets = Packet::Packets{memory};
 
             const uint8_t length_type_id = bits[index++];
 
@@ -148,7 +158,7 @@ namespace Year2021::Day16 {
                 while (index < target_index) {
                     auto [packet, end_index] = read_packet(index);
                     index = end_index;
-                    sub_packets.emplace_back(packet);
+                    sub_packets.emplace_back(std::move(packet));
                 }
             }
 
@@ -161,11 +171,11 @@ namespace Year2021::Day16 {
                 for (size_t i = 0; i < sub_packet_count; ++i) {
                     auto [packet, end_index] = read_packet(index);
                     index = end_index;
-                    sub_packets.emplace_back(packet);
+                    sub_packets.emplace_back(std::move(packet));
                 }
             }
 
-            return ReadResult<Packet>{Packet{version, type, sub_packets}, index};
+            return ReadResult<Packet>{Packet{version, type, std::move(sub_packets)}, index};
         }
 
         // 3 bits
@@ -203,19 +213,84 @@ namespace Year2021::Day16 {
     class Solver : public Base {
         using Base::Solver;
 
-        Answers solve(std::ifstream &input) const override {
+      public:
+        // One transmission with 150 literals per scale, under a tree of operators that gets deeper as it grows.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto bits = vector<bool>{};
+            const auto write = [&](uint64_t value, size_t count) {
+                for (size_t i = count; i-- > 0;) {
+                    bits.emplace_back((value >> i) & 1);
+                }
+            };
+
+            const auto write_packet = [&](const auto &self, size_t literals) -> void {
+                static constexpr uint64_t TWO_OPERAND_TYPES[] = {0, 1, 2, 3, 5, 6, 7};
+
+                write(random.below(8), 3);
+                if (literals == 1) {
+                    write(4, 3);
+                    for (size_t group = 3; group-- > 0;) {
+                        write(group > 0 ? 1 : 0, 1);
+                        write(random.below(16), 4);
+                    }
+                    return;
+                }
+
+                // Comparisons need exactly two sub-packets, the rest take any number.
+                const auto children = literals == 2 || random.chance(1, 4)
+                    ? size_t{2}
+                    : static_cast<size_t>(random.between(2, static_cast<int64_t>(std::min(literals, size_t{6}))));
+                write(children == 2 ? random.pick(TWO_OPERAND_TYPES) : random.below(4), 3);
+                write(1, 1);
+                write(children, 11);
+                for (size_t i = 0; i < children; ++i) {
+                    self(self, literals / children + (i < literals % children ? 1 : 0));
+                }
+            };
+            write_packet(write_packet, 150 * scale);
+
+            auto input = std::string{};
+            for (size_t i = 0; i < bits.size(); i += 4) {
+                auto digit = 0;
+                for (size_t j = i; j < i + 4; ++j) {
+                    digit = (digit << 1) | (j < bits.size() && bits[j] ? 1 : 0);
+                }
+                input += "0123456789ABCDEF"[digit];
+            }
+            return input + '\n';
+        }
+
+      private:
+        Answers solve(std::istream &input) const override {
             const auto bits = read_binary(input);
 
-            const auto packet = PacketReader{bits}.read_packet(0).data;
+            const auto packet = PacketReader{bits, arena()}.read_packet(0).data;
 
-            return Answers{Answer{"Sum of version numbers in all packets", packet.sum_of_all_version_numbers()},
+            return Answers{Answer{"Sum of version numbers in all packets", packet.sum_of_all_version_numbers(arena())},
                            Answer{"Evaluated value of top-level packet", packet.evaluate()}};
         };
 
       private:
-        static const unordered_map<char, array<uint8_t, 4>> HEX_DIGITS_TO_BINARY_BITS;
-
-        static vector<bool> read_binary(std::ifstream &input) {
+        static constexpr auto HEX_DIGITS_TO_BINARY_BITS =
+            Utils::CharTable<array<uint8_t, 4>>{{'0', array<uint8_t, 4>{0, 0, 0, 0}},
+                                                {'1', array<uint8_t, 4>{0, 0, 0, 1}},
+                                                {'2', array<uint8_t, 4>{0, 0, 1, 0}},
+                                                {'3', array<uint8_t, 4>{0, 0, 1, 1}},
+                                                {'4', array<uint8_t, 4>{0, 1, 0, 0}},
+                                                {'5', array<uint8_t, 4>{0, 1, 0, 1}},
+                                                {'6', array<uint8_t, 4>{0, 1, 1, 0}},
+                                                {'7', array<uint8_t, 4>{0, 1, 1, 1}},
+                                                {'8', array<uint8_t, 4>{1, 0, 0, 0}},
+                                                {'9', array<uint8_t, 4>{1, 0, 0, 1}},
+                                                {'A', array<uint8_t, 4>{1, 0, 1, 0}},
+                                                {'B', array<uint8_t, 4>{1, 0, 1, 1}},
+                                                {'C', array<uint8_t, 4>{1, 1, 0, 0}},
+                                                {'D', array<uint8_t, 4>{1, 1, 0, 1}},
+                                                {'E', array<uint8_t, 4>{1, 1, 1, 0}},
+                                                {'F', array<uint8_t, 4>{1, 1, 1, 1}}};
+
+        static vector<bool> read_binary(std::istream &input) {
             auto out = vector<bool>{};
 
             auto c = char{};
@@ -228,29 +303,12 @@ namespace Year2021::Day16 {
             return out;
         }
     };
-
-    const unordered_map<char, array<uint8_t, 4>> Solver::HEX_DIGITS_TO_BINARY_BITS =
-        unordered_map<char, array<uint8_t, 4>>{{'0', array<uint8_t, 4>{0, 0, 0, 0}},
-                                               {'1', array<uint8_t, 4>{0, 0, 0, 1}},
-                                               {'2', array<uint8_t, 4>{0, 0, 1, 0}},
-                                               {'3', array<uint8_t, 4>{0, 0, 1, 1}},
-                                               {'4', array<uint8_t, 4>{0, 1, 0, 0}},
-                                               {'5', array<uint8_t, 4>{0, 1, 0, 1}},
-                                               {'6', array<uint8_t, 4>{0, 1, 1, 0}},
-                                               {'7', array<uint8_t, 4>{0, 1, 1, 1}},
-                                               {'8', array<uint8_t, 4>{1, 0, 0, 0}},
-                                               {'9', array<uint8_t, 4>{1, 0, 0, 1}},
-                                               {'A', array<uint8_t, 4>{1, 0, 1, 0}},
-                                               {'B', array<uint8_t, 4>{1, 0, 1, 1}},
-                                               {'C', array<uint8_t, 4>{1, 1, 0, 0}},
-                                               {'D', array<uint8_t, 4>{1, 1, 0, 1}},
-                                               {'E', array<uint8_t, 4>{1, 1, 1, 0}},
-                                               {'F', array<uint8_t, 4>{1, 1, 1, 1}}};
 } // namespace Year2021::Day16
 
+static const auto registration = Common::Registration<Year2021::Day16::Solver>{2021, 16};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day16::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
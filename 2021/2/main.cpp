@@ -1,7 +1,10 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
 #include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace Year2021::Day2 {
@@ -22,20 +25,17 @@ namespace Year2021::Day2 {
             } part2;
         };
 
-      protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            auto pos = SubPosition{{0, 0}, {0, 0, 0}};
-
-            while (input.good() && input.peek() != std::char_traits<char>::eof()) {
-                const auto instruction = read_instruction(input);
-
-                auto executor = OPERATION_EXECUTORS.at(instruction.op);
-                executor(pos, instruction.value);
+      public:
+        // 1000 commands per scale. Going down is a little more likely than up, so the sub ends up below the surface.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 1000 * scale; ++i) {
+                const auto roll = random.below(100);
+                input += roll < 35 ? "forward " : roll < 73 ? "down " : "up ";
+                input += std::to_string(random.between(1, 9)) + '\n';
             }
-
-            return Base::Answers{
-                Base::Answer{"Final horizontal x final depth", pos.part1.depth * pos.part1.horizontal},
-                Base::Answer{"Final horizontal x final depth", pos.part2.depth * pos.part2.horizontal}};
+            return input;
         }
 
       private:
@@ -43,21 +43,48 @@ namespace Year2021::Day2 {
         static const std::unordered_map<std::string, Operation> OPERATION_STRING_MAP;
         static const std::unordered_map<Operation, std::function<void(SubPosition &, long value)>> OPERATION_EXECUTORS;
 
+      public:
+        // One command per line, each moving the sub on from where the last left it.
+        struct CommandFold {
+            SubPosition pos{{0, 0}, {0, 0, 0}};
+
+            void add(std::string_view line) {
+                line = Utils::trim(line);
+                if (line.empty()) {
+                    return;
+                }
+
+                const auto instruction = read_instruction(line);
+                auto executor = OPERATION_EXECUTORS.at(instruction.op);
+                executor(pos, instruction.value);
+            }
+
+            Base::Answers answers() const {
+                return Base::Answers{
+                    Base::Answer{"Final horizontal x final depth", pos.part1.depth * pos.part1.horizontal},
+                    Base::Answer{"Final horizontal x final depth", pos.part2.depth * pos.part2.horizontal}};
+            }
+        };
+        using Incremental = Common::RecordFoldSolver<long, CommandFold>;
+
+      protected:
+        Base::Answers solve(std::istream &input) const override { return Incremental{}.solve(input); }
+
+      private:
         using Instruction = struct {
             Operation op;
             long value;
         };
 
-        static Instruction read_instruction(std::ifstream &input) {
-            long v;
-            auto s = std::string{};
-            if (!(input >> s >> v)) {
+        // e.g. "forward 5"
+        static Instruction read_instruction(std::string_view line) {
+            const auto space = line.find(' ');
+            if (space == std::string_view::npos) {
                 throw Error{"malformed_input"};
             }
 
-            input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-            return Instruction{OPERATION_STRING_MAP.at(s), v};
+            return Instruction{OPERATION_STRING_MAP.at(std::string{line.substr(0, space)}),
+                               Utils::str_to_int<long>(Utils::trim(line.substr(space + 1)))};
         }
     };
 
@@ -87,9 +114,10 @@ namespace Year2021::Day2 {
             };
 } // namespace Year2021::Day2
 
+static const auto registration = Common::Registration<Year2021::Day2::Solver>{2021, 2};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day2::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
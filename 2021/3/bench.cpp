@@ -0,0 +1,42 @@
+#include "main.cpp"
+
+#include "../../bench.h"
+#include "../../random.h"
+
+#include <string>
+#include <vector>
+
+namespace Year2021::Day3 {
+    struct Bench {
+        // As many random 12 bit numbers as a puzzle input has, filtered down by the oxygen generator rule.
+        static Common::Microbenchmark find_rating_by_rule() {
+            static constexpr size_t NUMBERS = 1000;
+            static constexpr size_t BITS = 12;
+
+            auto random = Common::Random{1};
+            auto numbers = std::vector<std::string>(NUMBERS);
+            for (auto &number : numbers) {
+                for (size_t i = 0; i < BITS; ++i) {
+                    number += random.chance(1, 2) ? '1' : '0';
+                }
+            }
+            auto bit_frequency_indicator = Solver::calculate_bit_frequency_indicator(numbers);
+
+            // One filtering of all the numbers per batch, so ns/item is the time of a whole find_rating_by_rule call.
+            return Common::Microbenchmark{"find_rating_by_rule",
+                                          1,
+                                          NUMBERS * BITS,
+                                          [numbers = std::move(numbers),
+                                           bit_frequency_indicator = std::move(bit_frequency_indicator)]() {
+                                              Common::do_not_optimize(Solver::find_rating_by_rule(
+                                                  numbers, bit_frequency_indicator, [](auto v) {
+                                                      return v > -1 ? '1' : '0';
+                                                  }));
+                                          }};
+        }
+    };
+} // namespace Year2021::Day3
+
+int main(int argc, char **argv) {
+    return Common::bench_main(argc, argv, {Year2021::Day3::Bench::find_rating_by_rule()});
+}
@@ -1,5 +1,8 @@
+#include "../../random.h"
 #include "../../solver.h"
 
+#include <algorithm>
+#include <bit>
 #include <bitset>
 #include <functional>
 #include <iterator>
@@ -16,8 +19,57 @@ namespace Year2021::Day3 {
         using BitFrequencyIndicatorValue = long;
         using BitFrequencyIndicator = std::vector<BitFrequencyIndicatorValue>;
 
+      public:
+        // 1000 distinct random numbers per scale, 12 bits wide at 1x & wider as needed to keep them a quarter dense.
+        // The rating filters need every group they narrow down to (2+ numbers sharing a prefix) to differ in the next
+        // bit, so each such group that doesn't has one number's bit flipped into the empty half.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            const auto count = 1000 * scale;
+            const auto bits = static_cast<size_t>(std::bit_width(4 * count - 1));
+
+            auto seen = std::unordered_set<uint64_t>{};
+            while (seen.size() < count) {
+                seen.insert(random.below(uint64_t{1} << bits));
+            }
+            // Sorted, a prefix's numbers are a contiguous range & the flips below keep them sorted.
+            auto numbers = std::vector<uint64_t>(seen.begin(), seen.end());
+            std::sort(numbers.begin(), numbers.end());
+
+            for (const auto keep_most_common : {true, false}) {
+                auto lo = size_t{0}, hi = numbers.size();
+                for (size_t bit = bits; hi - lo > 1;) {
+                    const auto mask = uint64_t{1} << --bit;
+                    const auto first = numbers.begin() + static_cast<std::ptrdiff_t>(lo);
+                    const auto last = numbers.begin() + static_cast<std::ptrdiff_t>(hi);
+                    auto split = static_cast<size_t>(
+                        std::partition_point(first, last, [=](auto n) { return !(n & mask); }) - numbers.begin());
+                    if (split == hi) {
+                        numbers[--split] |= mask;
+                    } else if (split == lo) {
+                        numbers[split++] &= ~mask;
+                    }
+
+                    const auto keep_ones = (hi - split >= split - lo) == keep_most_common;
+                    (keep_ones ? lo : hi) = split;
+                }
+            }
+
+            for (size_t i = numbers.size(); i > 1; --i) {
+                std::swap(numbers[i - 1], numbers[random.below(i)]);
+            }
+            auto input = std::string{};
+            for (const auto number : numbers) {
+                for (size_t i = bits; i-- > 0;) {
+                    input += (number >> i) & 1 ? '1' : '0';
+                }
+                input += '\n';
+            }
+            return input;
+        }
+
       protected:
-        Base::Answers solve(std::ifstream &input) const override {
+        Base::Answers solve(std::istream &input) const override {
             const auto numbers = std::vector<std::string>{std::istream_iterator<std::string>(input),
                                                           std::istream_iterator<std::string>{}};
             if (numbers.empty()) {
@@ -32,13 +84,20 @@ namespace Year2021::Day3 {
 
             const auto bit_frequency_indicator = calculate_bit_frequency_indicator(numbers);
 
-            return Base::Answers{
-                Base::Answer{"Power consumption (gamma x epsilon)", power_consumption(bit_frequency_indicator)},
-                Base::Answer{"Life support rating (o2 rating x co2 rating)",
-                             life_support_rating(numbers, bit_frequency_indicator)}};
+            return solve_parts(
+                [&]() {
+                    return Base::Answer{"Power consumption (gamma x epsilon)",
+                                        power_consumption(bit_frequency_indicator)};
+                },
+                [&]() {
+                    return Base::Answer{"Life support rating (o2 rating x co2 rating)",
+                                        life_support_rating(numbers, bit_frequency_indicator)};
+                });
         }
 
       private:
+        friend struct Bench;
+
         static unsigned long power_consumption(const BitFrequencyIndicator &bit_frequency_indicator) {
             const auto bits_difference_from_max = MAX_BITS_COUNT - bit_frequency_indicator.size();
             const auto bits_mask =
@@ -145,9 +204,10 @@ namespace Year2021::Day3 {
     };
 } // namespace Year2021::Day3
 
+static const auto registration = Common::Registration<Year2021::Day3::Solver>{2021, 3};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day3::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -1,7 +1,8 @@
+#include "../../random.h"
 #include "../../solver.h"
+#include "../../utils.h"
 
 #include <bitset>
-#include <charconv>
 #include <functional>
 #include <unordered_map>
 #include <unordered_set>
@@ -68,8 +69,48 @@ namespace Year2021::Day4 {
     class Solver : public Base {
         using Base::Solver;
 
+      public:
+        // Every number 0-99 drawn in a random order, then 100 cards per scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+
+            auto numbers = std::array<BingoCardNumber, 100>{};
+            std::iota(numbers.begin(), numbers.end(), BingoCardNumber{0});
+            const auto shuffle_first = [&](size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    std::swap(numbers[i], numbers[i + random.below(numbers.size() - i)]);
+                }
+            };
+
+            shuffle_first(numbers.size());
+            auto input = std::string{};
+            for (size_t i = 0; i < numbers.size(); ++i) {
+                if (i > 0) {
+                    input += ',';
+                }
+                input += std::to_string(numbers[i]);
+            }
+            input += '\n';
+
+            for (size_t card = 0; card < 100 * scale; ++card) {
+                shuffle_first(BINGO_CARD_TOTAL_NUMBERS);
+                input += '\n';
+                for (size_t i = 0; i < BINGO_CARD_TOTAL_NUMBERS; ++i) {
+                    if (i % BINGO_CARD_COLUMNS > 0) {
+                        input += ' ';
+                    }
+                    const auto number = std::to_string(numbers[i]);
+                    input += std::string(2 - number.size(), ' ') + number;
+                    if (i % BINGO_CARD_COLUMNS == BINGO_CARD_COLUMNS - 1) {
+                        input += '\n';
+                    }
+                }
+            }
+            return input;
+        }
+
       protected:
-        Base::Answers solve(std::ifstream &input) const override {
+        Base::Answers solve(std::istream &input) const override {
             const auto numbers = read_numbers_picked(input);
             auto cards = read_cards(input);
             auto number_to_cards_map = make_number_to_cards_map(cards);
@@ -84,7 +125,7 @@ namespace Year2021::Day4 {
             const std::vector<BingoCardNumber> &numbers,
             std::unordered_multimap<BingoCardNumber, std::tuple<BingoCard *, size_t>> &number_to_cards_map,
             size_t card_count) {
-            unsigned long long first_win_score, last_win_score;
+            unsigned long long first_win_score{}, last_win_score{};
 
             auto winning_cards = std::unordered_set<const BingoCard *>{};
 
@@ -114,7 +155,7 @@ namespace Year2021::Day4 {
             return std::make_pair(first_win_score, last_win_score);
         }
 
-        static std::vector<BingoCard> read_cards(std::ifstream &input) {
+        static std::vector<BingoCard> read_cards(std::istream &input) {
             auto cards = std::vector<BingoCard>{};
 
             auto current_card_numbers = BingoCardNumbers{};
@@ -129,34 +170,13 @@ namespace Year2021::Day4 {
             return cards;
         }
 
-        static std::vector<BingoCardNumber> read_numbers_picked(std::ifstream &input) {
+        static std::vector<BingoCardNumber> read_numbers_picked(std::istream &input) {
             std::string str;
             if (!(input >> str)) {
                 throw Error{"malformed_input"};
             }
 
-            const auto str_view = std::string_view{str};
-
-            auto numbers = std::vector<BingoCardNumber>{};
-
-            size_t pos = 0;
-            size_t delim_pos = 0;
-            while ((delim_pos = str_view.find(',', pos)) != std::string::npos) {
-                numbers.emplace_back(str_to_ull(str_view.substr(pos, delim_pos - pos)));
-                pos = delim_pos + 1;
-            }
-            numbers.emplace_back(str_to_ull(str_view.substr(pos)));
-
-            return numbers;
-        }
-
-        static unsigned long long str_to_ull(const std::string_view &str) {
-            unsigned long long number = 0;
-            auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), number);
-            if (err != std::errc{} || ptr != str.data() + str.size()) {
-                throw Error{"malformed_input"};
-            }
-            return number;
+            return Utils::parse_int_list<BingoCardNumber>(str);
         }
 
         static std::unordered_multimap<BingoCardNumber, std::tuple<BingoCard *, size_t>>
@@ -177,9 +197,10 @@ namespace Year2021::Day4 {
     };
 } // namespace Year2021::Day4
 
+static const auto registration = Common::Registration<Year2021::Day4::Solver>{2021, 4};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day4::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
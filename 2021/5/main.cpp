@@ -1,6 +1,9 @@
+#include "../../random.h"
 #include "../../solver.h"
 
+#include <algorithm>
 #include <numeric>
+#include <string>
 
 namespace Year2021::Day5 {
     using Base = ::Common::Solver<unsigned long long>;
@@ -15,8 +18,8 @@ namespace Year2021::Day5 {
                                          std::make_pair(size_t(0), size_t(0)),
                                          [](auto acc, const auto &l) {
                                              return std::make_pair(
-                                                 std::max((size_t)std::max(l.first.x, l.second.x), acc.first),
-                                                 std::max((size_t)std::max(l.first.y, l.second.y), acc.second));
+                                                 std::max((size_t)std::max(l.first.x, l.second.x) + 1, acc.first),
+                                                 std::max((size_t)std::max(l.first.y, l.second.y) + 1, acc.second));
                                          })),
               overlapping_points(dimensions.first * dimensions.second),
               overlapping_points_from_straight_lines(dimensions.first * dimensions.second) {}
@@ -55,9 +58,41 @@ namespace Year2021::Day5 {
     class Solver : public Base {
         using Base::Solver;
 
+      public:
+        // 500 random horizontal, vertical or 45 degree lines per scale, all within the puzzle's 1000x1000 area.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr long long SIZE = 1000;
+
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 500 * scale; ++i) {
+                const auto x1 = random.between(0, SIZE - 1), y1 = random.between(0, SIZE - 1);
+                auto x2 = x1, y2 = y1;
+                switch (random.below(3)) {
+                case 0:
+                    x2 = random.between(0, SIZE - 1);
+                    break;
+                case 1:
+                    y2 = random.between(0, SIZE - 1);
+                    break;
+                default: {
+                    const auto dx = random.chance(1, 2) ? 1 : -1, dy = random.chance(1, 2) ? 1 : -1;
+                    const auto room = std::min(dx > 0 ? SIZE - 1 - x1 : x1, dy > 0 ? SIZE - 1 - y1 : y1);
+                    const auto length = random.between(0, room);
+                    x2 = x1 + dx * length;
+                    y2 = y1 + dy * length;
+                    break;
+                }
+                }
+                input += std::to_string(x1) + ',' + std::to_string(y1) + " -> " + std::to_string(x2) + ',' +
+                    std::to_string(y2) + '\n';
+            }
+            return input;
+        }
+
       protected:
-        Base::Answers solve(std::ifstream &input) const override {
-            const auto lines = read_lines(input);
+        Base::Answers solve(std::istream &input) const override {
+            const auto [lines] = parse_or_load(input, read_lines);
             auto overlap_tracker = OverlapTracker{lines};
 
             auto point = Point{};
@@ -111,7 +146,36 @@ namespace Year2021::Day5 {
         }
 
       private:
-        static std::vector<Line> read_lines(std::ifstream &input) {
+        struct Lines {
+            std::vector<Line> lines;
+
+            // Four coordinates per line, x1 y1 x2 y2.
+            void write_snapshot(Common::SnapshotWriter &writer) const {
+                auto coordinates = std::vector<int64_t>{};
+                coordinates.reserve(lines.size() * 4);
+                for (const auto &[start, end] : lines) {
+                    coordinates.insert(coordinates.end(), {start.x, start.y, end.x, end.y});
+                }
+                writer.put_array(coordinates.data(), coordinates.size());
+            }
+
+            static Lines read_snapshot(Common::SnapshotReader &reader) {
+                const auto coordinates = reader.get_array<int64_t>();
+                if (coordinates.size() % 4 != 0) {
+                    throw Error{"malformed_snapshot"};
+                }
+
+                auto out = Lines{};
+                out.lines.reserve(coordinates.size() / 4);
+                for (size_t i = 0; i < coordinates.size(); i += 4) {
+                    out.lines.emplace_back(Point{coordinates[i], coordinates[i + 1]},
+                                           Point{coordinates[i + 2], coordinates[i + 3]});
+                }
+                return out;
+            }
+        };
+
+        static Lines read_lines(std::istream &input) {
             auto lines = std::vector<Line>{};
 
             auto start_point = Point{};
@@ -123,14 +187,15 @@ namespace Year2021::Day5 {
                 lines.emplace_back(start_point, end_point);
             }
 
-            return lines;
+            return Lines{std::move(lines)};
         }
     };
 } // namespace Year2021::Day5
 
+static const auto registration = Common::Registration<Year2021::Day5::Solver>{2021, 5, std::chrono::milliseconds{15}};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day5::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
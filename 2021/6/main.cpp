@@ -1,31 +1,64 @@
+#include "../../random.h"
 #include "../../solver.h"
 #include "../../utils.h"
 
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
+
 #include <array>
 #include <numeric>
-#include <unordered_map>
 
 namespace Year2021::Day6 {
     using Base = ::Common::Solver<unsigned long long>;
     using Answers = Base::Answers;
     using Answer = Base::Answer;
 
-    const size_t MAX_FISH_BIO_TIMER = 8;
+    constexpr size_t MAX_FISH_BIO_TIMER = 8;
 
     // This will track how many fish are at a certain timer age (aka the array index)
     using FishBioTimerTracker = std::array<unsigned long long, MAX_FISH_BIO_TIMER + 1>;
 
-    const size_t FISH_BIO_TIMER_CHILD_AT_BIRTH = 8;
-    const size_t FISH_BIO_TIMER_PARENT_AT_BIRTH = 6;
+    constexpr size_t FISH_BIO_TIMER_CHILD_AT_BIRTH = 8;
+    constexpr size_t FISH_BIO_TIMER_PARENT_AT_BIRTH = 6;
 
     class Solver : public Base {
         using Base::Solver;
 
+      public:
+        // 300 fish per scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 300 * scale; ++i) {
+                if (i > 0) {
+                    input += ',';
+                }
+                input += std::to_string(random.between(1, 5));
+            }
+            return input + '\n';
+        }
+
       protected:
-        Answers solve(std::ifstream &input) const override {
-            auto tracker = read_initial_state(input);
+        InputMode input_mode() const override { return InputMode::mapped; }
 
-            auto fish_count_at_certain_days = std::unordered_map<unsigned, unsigned long long>{{80, 0}, {256, 0}};
+        Answers solve_mapped(std::string_view input) const override { return to_answers(count_fish(input)); }
+
+      private:
+        struct FishCounts {
+            unsigned long long after_80_days;
+            unsigned long long after_256_days;
+        };
+
+        static Answers to_answers(const FishCounts &counts) {
+            return Answers{Answer{"Fish count after 80 days", counts.after_80_days},
+                           Answer{"Fish count after 256 days", counts.after_256_days}};
+        }
+
+        // Allocation-free, so that it can also run at compile time on an embedded input.
+        static constexpr FishCounts count_fish(std::string_view input) {
+            auto tracker = read_initial_state(input);
+            auto counts = FishCounts{};
 
             const auto num_days_to_simulate = size_t{256};
             for (size_t i = 0; i < num_days_to_simulate; ++i) {
@@ -43,51 +76,48 @@ namespace Year2021::Day6 {
 
                 tracker = new_tracker;
 
-                if (fish_count_at_certain_days.find(i + 1) != fish_count_at_certain_days.end()) {
-                    fish_count_at_certain_days[i + 1] =
-                        std::accumulate(tracker.begin(), tracker.end(), (unsigned long long)0);
+                if (i + 1 == 80) {
+                    counts.after_80_days = std::accumulate(tracker.begin(), tracker.end(), (unsigned long long)0);
                 }
             }
+            counts.after_256_days = std::accumulate(tracker.begin(), tracker.end(), (unsigned long long)0);
 
-            return Answers{Answer{"Fish count after 80 days", fish_count_at_certain_days[80]},
-                           Answer{"Fish count after 256 days", fish_count_at_certain_days[256]}};
+            return counts;
         }
 
-      private:
-        static FishBioTimerTracker read_initial_state(std::ifstream &input) {
+        static constexpr FishBioTimerTracker read_initial_state(std::string_view input) {
             auto tracker = FishBioTimerTracker{};
 
-            std::string str;
-            if (!(input >> str)) {
-                throw Error{"malformed_input"};
-            }
-
-            const auto str_view = std::string_view{str};
-
-            size_t pos = 0;
-            size_t delim_pos = 0;
-            while ((delim_pos = str_view.find(',', pos)) != std::string::npos) {
-                const auto age = Utils::str_to_int(str_view.substr(pos, delim_pos - pos));
+            auto fish = size_t{0};
+            Utils::for_each_int<unsigned>(input, ',', [&](unsigned age) {
                 if (age > MAX_FISH_BIO_TIMER) {
                     throw Error{"malformed_input"};
                 }
                 ++tracker[age];
-                pos = delim_pos + 1;
-            }
-            const auto age = Utils::str_to_int(str_view.substr(pos, delim_pos - pos));
-            if (age > MAX_FISH_BIO_TIMER) {
+                ++fish;
+            });
+            if (fish == 0) {
                 throw Error{"malformed_input"};
             }
-            ++tracker[age];
 
             return tracker;
         }
+
+#ifdef AOC_EMBED_INPUT
+      protected:
+        // After count_fish(), which has to be defined before it can be evaluated.
+        std::optional<Answers> embedded_answers() const override {
+            static constexpr auto EMBEDDED_FISH_COUNTS = count_fish(EMBEDDED_INPUT);
+            return to_answers(EMBEDDED_FISH_COUNTS);
+        }
+#endif
     };
 } // namespace Year2021::Day6
 
+static const auto registration = Common::Registration<Year2021::Day6::Solver>{2021, 6};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day6::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
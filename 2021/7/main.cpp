@@ -1,8 +1,13 @@
+#include "../../random.h"
 #include "../../solver.h"
 #include "../../utils.h"
 
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
+
 #include <algorithm>
-#include <cmath>
+#include <array>
 #include <numeric>
 #include <vector>
 
@@ -14,18 +19,42 @@ namespace Year2021::Day7 {
     class Solver : public Base {
         using Base::Solver;
 
+      public:
+        // 1000 crabs per scale.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            auto input = std::string{};
+            for (size_t i = 0; i < 1000 * scale; ++i) {
+                if (i > 0) {
+                    input += ',';
+                }
+                input += std::to_string(random.between(0, 1999));
+            }
+            return input + '\n';
+        }
+
       protected:
-        Answers solve(std::ifstream &input) const override {
+        InputMode input_mode() const override { return InputMode::mapped; }
+
+        Answers solve_mapped(std::string_view input) const override {
             const auto positions = read_numbers(input);
 
-            return Answers{Answer{"Least fuel required to align with constant fuel usage",
-                                  least_constant_fuel_to_align(positions)},
-                           Answer{"Least fuel required to align with linearly increasing fuel usage",
-                                  least_linear_fuel_to_align(positions)}};
+            return solve_parts(
+                [&]() {
+                    return Answer{CONSTANT_FUEL, least_constant_fuel_to_align(positions)};
+                },
+                [&]() {
+                    return Answer{LINEAR_FUEL, least_linear_fuel_to_align(positions)};
+                });
         }
 
       private:
-        static long long least_constant_fuel_to_align(const std::vector<long long> &positions) {
+        static constexpr auto CONSTANT_FUEL = "Least fuel required to align with constant fuel usage";
+        static constexpr auto LINEAR_FUEL = "Least fuel required to align with linearly increasing fuel usage";
+
+        // These are constexpr so that they can also run at compile time on an embedded input; std::abs, std::floor &
+        // std::ceil aren't until C++23.
+        static constexpr long long least_constant_fuel_to_align(const std::vector<long long> &positions) {
             auto positions_sortable = positions;
 
             // Sort enough to find median
@@ -37,54 +66,57 @@ namespace Year2021::Day7 {
             return std::accumulate(positions_sortable.begin(),
                                    positions_sortable.end(),
                                    (long long)0,
-                                   [=](auto acc, auto p) { return acc + std::abs(median - p); });
+                                   [=](auto acc, auto p) { return acc + distance(median, p); });
         }
 
-        static long long least_linear_fuel_to_align(const std::vector<long long> &positions) {
-            const auto mean =
-                std::accumulate(positions.begin(), positions.end(), (long long)0) / (long double)positions.size();
-            const auto mean_floor = static_cast<long long>(std::floor(mean));
-            const auto mean_ceil = static_cast<long long>(std::ceil(mean));
+        static constexpr long long least_linear_fuel_to_align(const std::vector<long long> &positions) {
+            const auto count = static_cast<long long>(positions.size());
+            const auto sum = std::accumulate(positions.begin(), positions.end(), (long long)0);
+            const auto mean_floor = sum / count - (sum % count < 0);
+            const auto mean_ceil = mean_floor + (sum % count != 0);
 
             return std::min(std::accumulate(positions.begin(),
                                             positions.end(),
                                             (long long)0,
                                             [=](auto acc, auto p) {
-                                                return acc + linear_fuel_usage_for_steps(std::abs(mean_floor - p));
+                                                return acc + linear_fuel_usage_for_steps(distance(mean_floor, p));
                                             }),
                             std::accumulate(positions.begin(), positions.end(), (long long)0, [=](auto acc, auto p) {
-                                return acc + linear_fuel_usage_for_steps(std::abs(mean_ceil - p));
+                                return acc + linear_fuel_usage_for_steps(distance(mean_ceil, p));
                             }));
         }
 
-        static long long linear_fuel_usage_for_steps(long long steps) { return steps * (steps + 1) / 2; }
+        static constexpr long long distance(long long a, long long b) { return a < b ? b - a : a - b; }
 
-        static std::vector<long long> read_numbers(std::ifstream &input) {
-            auto numbers = std::vector<long long>{};
+        static constexpr long long linear_fuel_usage_for_steps(long long steps) { return steps * (steps + 1) / 2; }
 
-            std::string str;
-            if (!(input >> str)) {
+        static constexpr std::vector<long long> read_numbers(std::string_view input) {
+            auto numbers = Utils::parse_int_list<long long>(input);
+            if (numbers.empty()) {
                 throw Error{"malformed_input"};
             }
-
-            const auto str_view = std::string_view{str};
-
-            size_t pos = 0;
-            size_t delim_pos = 0;
-            while ((delim_pos = str_view.find(',', pos)) != std::string::npos) {
-                numbers.emplace_back(Utils::str_to_int<long long>(str_view.substr(pos, delim_pos - pos)));
-                pos = delim_pos + 1;
-            }
-            numbers.emplace_back(Utils::str_to_int<long long>(str_view.substr(pos, delim_pos - pos)));
-
             return numbers;
         }
+
+#ifdef AOC_EMBED_INPUT
+      protected:
+        // After the parts above, which have to be defined before they can be evaluated.
+        std::optional<Answers> embedded_answers() const override {
+            // The positions are only allocated during constant evaluation; only the two answers are kept.
+            static constexpr auto EMBEDDED_FUEL = [] {
+                const auto positions = read_numbers(EMBEDDED_INPUT);
+                return std::array{least_constant_fuel_to_align(positions), least_linear_fuel_to_align(positions)};
+            }();
+            return Answers{Answer{CONSTANT_FUEL, EMBEDDED_FUEL[0]}, Answer{LINEAR_FUEL, EMBEDDED_FUEL[1]}};
+        }
+#endif
     };
 } // namespace Year2021::Day7
 
+static const auto registration = Common::Registration<Year2021::Day7::Solver>{2021, 7};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day7::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -0,0 +1,59 @@
+#include "main.cpp"
+
+#include "../../bench.h"
+#include "../../random.h"
+
+#include <array>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Year2021::Day8 {
+    struct Bench {
+        using SignalsBySegments = std::unordered_map<uint8_t, std::vector<Solver::RawSignal>>;
+
+        // Displays of all ten digits with their wires randomly swapped, as read_signals_and_digits groups them.
+        static std::vector<SignalsBySegments> generate_displays(size_t count) {
+            static constexpr std::string_view DIGIT_SEGMENTS[] = {
+                "abcefg", "cf", "acdeg", "acdfg", "bcdf", "abdfg", "abdefg", "acf", "abcdefg", "abcdfg"};
+
+            auto random = Common::Random{1};
+            auto displays = std::vector<SignalsBySegments>(count);
+            for (auto &display : displays) {
+                auto wiring = std::array<size_t, Solver::SEGMENT_COUNT>{};
+                std::iota(wiring.begin(), wiring.end(), 0);
+                for (size_t i = wiring.size() - 1; i > 0; --i) {
+                    std::swap(wiring[i], wiring[random.below(i + 1)]);
+                }
+
+                for (const auto segments : DIGIT_SEGMENTS) {
+                    auto &signal = display[static_cast<uint8_t>(segments.size())].emplace_back();
+                    for (const auto segment : segments) {
+                        signal.set(wiring[static_cast<size_t>(segment - 'a')]);
+                    }
+                }
+            }
+            return displays;
+        }
+
+        static Common::Microbenchmark calculate_signal_to_digit_mapping() {
+            static constexpr size_t DISPLAYS = 1000;
+
+            return Common::Microbenchmark{"calculate_signal_to_digit_mapping",
+                                          DISPLAYS,
+                                          0,
+                                          [displays = generate_displays(DISPLAYS)]() {
+                                              for (const auto &display : displays) {
+                                                  Common::do_not_optimize(
+                                                      Solver::calculate_signal_to_digit_mapping(display));
+                                              }
+                                          }};
+        }
+    };
+} // namespace Year2021::Day8
+
+int main(int argc, char **argv) {
+    return Common::bench_main(argc, argv, {Year2021::Day8::Bench::calculate_signal_to_digit_mapping()});
+}
@@ -1,8 +1,13 @@
+#include "../../random.h"
 #include "../../solver.h"
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace Year2021::Day8 {
@@ -18,8 +23,50 @@ namespace Year2021::Day8 {
         static const size_t SEGMENT_COUNT = 7;
         using RawSignal = std::bitset<SEGMENT_COUNT>; // Represents which segments are lit, a == 0, b == 1 .. g = 6
 
+      public:
+        // 200 displays per scale, each with its wires randomly swapped, its ten patterns shuffled (as are the segments
+        // within every pattern) & four random output digits.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            static constexpr std::string_view DIGIT_SEGMENTS[] = {
+                "abcefg", "cf", "acdeg", "acdfg", "bcdf", "abdfg", "abdefg", "acf", "abcdefg", "abcdfg"};
+
+            auto random = Common::Random{seed};
+            const auto shuffle = [&](auto &values) {
+                for (size_t i = values.size(); i > 1; --i) {
+                    std::swap(values[i - 1], values[random.below(i)]);
+                }
+            };
+
+            auto input = std::string{};
+            for (size_t i = 0; i < 200 * scale; ++i) {
+                auto wiring = std::string{"abcdefg"};
+                shuffle(wiring);
+                const auto pattern = [&](size_t digit) {
+                    auto out = std::string{};
+                    for (const auto segment : DIGIT_SEGMENTS[digit]) {
+                        out += wiring[static_cast<size_t>(segment - 'a')];
+                    }
+                    shuffle(out);
+                    return out;
+                };
+
+                auto digits = std::array<size_t, SIGNAL_VALUE_COUNT>{};
+                std::iota(digits.begin(), digits.end(), 0);
+                shuffle(digits);
+                for (const auto digit : digits) {
+                    input += pattern(digit) + ' ';
+                }
+                input += '|';
+                for (size_t j = 0; j < OUTPUT_VALUE_DIGITS; ++j) {
+                    input += ' ' + pattern(random.below(SIGNAL_VALUE_COUNT));
+                }
+                input += '\n';
+            }
+            return input;
+        }
+
       protected:
-        Answers solve(std::ifstream &input) const override {
+        Answers solve(std::istream &input) const override {
             size_t unique_segment_number_count = 0;
             unsigned long long total_sum = 0;
 
@@ -42,7 +89,9 @@ namespace Year2021::Day8 {
         }
 
       private:
-        static std::array<uint8_t, OUTPUT_VALUE_DIGITS> calculate_output_digits(std::ifstream &input) {
+        friend struct Bench;
+
+        static std::array<uint8_t, OUTPUT_VALUE_DIGITS> calculate_output_digits(std::istream &input) {
             auto [signals, digits] = read_signals_and_digits(input);
 
             const auto signal_to_digit_mapping = calculate_signal_to_digit_mapping(signals);
@@ -159,7 +208,7 @@ namespace Year2021::Day8 {
             std::vector<RawSignal> digits;
         };
 
-        static RawSignalsAndDigits read_signals_and_digits(std::ifstream &input) {
+        static RawSignalsAndDigits read_signals_and_digits(std::istream &input) {
             auto out = RawSignalsAndDigits{};
 
             auto str = std::string{};
@@ -197,9 +246,10 @@ namespace Year2021::Day8 {
     };
 } // namespace Year2021::Day8
 
+static const auto registration = Common::Registration<Year2021::Day8::Solver>{2021, 8};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day8::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -1,7 +1,11 @@
+#include "../../grid.h"
+#include "../../random.h"
 #include "../../solver.h"
 
 #include <algorithm>
+#include <cmath>
 #include <deque>
+#include <memory_resource>
 #include <numeric>
 #include <vector>
 
@@ -13,70 +17,57 @@ namespace Year2021::Day9 {
     class Solver : public Base {
         using Base::Solver;
 
-      protected:
-        class HeightMapGrid {
-          public:
-            HeightMapGrid(std::ifstream &input) {
-                std::string s;
-                if (!(input >> s)) {
-                    throw Error{"malformed_input"};
-                }
-
-                // Assuming all rows are same size
-                w = s.size() + 2;
-
-                // Add a dummy max height row at top
-                for (size_t i = 0; i < w; ++i) {
-                    height_map.emplace_back(9);
-                }
-                parse_row(s);
-
-                size_t rows = 2;
-                while (input >> s) {
-                    parse_row(s);
-                    ++rows;
+      public:
+        // A square heightmap with 100x100 points per scale. Overlapping waves give ridges of 9s between basins, much
+        // like the real input.
+        static std::string generate_input(size_t scale, uint64_t seed) {
+            auto random = Common::Random{seed};
+            const auto phase = [&]() { return static_cast<double>(random.below(6283)) / 1000.0; };
+            const auto a = phase(), b = phase(), c = phase();
+
+            const auto side = static_cast<size_t>(std::lround(100 * std::sqrt(static_cast<double>(scale))));
+            auto input = std::string{};
+            for (size_t y = 0; y < side; ++y) {
+                for (size_t x = 0; x < side; ++x) {
+                    const auto fx = static_cast<double>(x), fy = static_cast<double>(y);
+                    const auto height = 4.5 + 3.0 * std::sin(fx / 3.0 + a) * std::sin(fy / 3.0 + b) +
+                        2.0 * std::sin((fx + fy) / 7.0 + c) + static_cast<double>(random.between(-5, 5)) / 10.0;
+                    input += static_cast<char>('0' + std::clamp(std::lround(height), 0L, 9L));
                 }
-
-                // Add a dummy max height row at top
-                for (size_t i = 0; i < w; ++i) {
-                    height_map.emplace_back(9);
-                }
-                h = rows + 1;
+                input += '\n';
             }
+            return input;
+        }
 
-            size_t width() const { return w; }
-            size_t height() const { return h; }
-            uint8_t at(size_t x, size_t y) const { return height_map[unique_idx(x, y)]; }
-            size_t unique_idx(size_t x, size_t y) const { return x + y * w; }
+      protected:
+        using HeightMapGrid = Common::Grid<uint8_t>;
 
-          private:
-            size_t w;
-            size_t h;
-            std::vector<uint8_t> height_map;
+        // Heights are 0-9 & 9 is never part of a basin, so a halo of 9s stops basins at the edges without bounds
+        // checks.
+        static const uint8_t EDGE_HEIGHT = 9;
 
-            void parse_row(const std::string &s) {
-                height_map.emplace_back(9); // add 9 as first column
-                for (auto c : s) {
-                    height_map.emplace_back(c - '0');
-                }
-                height_map.emplace_back(9); // add 9 as last column
-            }
-        };
+        InputMode input_mode() const override { return InputMode::mapped; }
+
+        Answers solve_mapped(std::string_view input) const override {
+            const auto grid = HeightMapGrid::parse_digits(input, 1, EDGE_HEIGHT);
 
-        Answers solve(std::ifstream &input) const override {
-            const auto grid = HeightMapGrid(input);
+            auto low_points = grid.like<uint8_t>();
+            grid.map_4(low_points, [](uint8_t value, uint8_t n, uint8_t w, uint8_t e, uint8_t s) -> uint8_t {
+                return value < n && value < w && value < e && value < s;
+            });
 
             auto sum_of_low_point_risk = (unsigned long long){0};
             auto basin_sizes = std::vector<size_t>{};
-
-            for (size_t x = 1; x < grid.width() - 1; ++x) {
-                for (size_t y = 1; y < grid.height() - 1; ++y) {
-                    const auto value = grid.at(x, y);
-                    if (value < grid.at(x - 1, y) && value < grid.at(x + 1, y) && value < grid.at(x, y - 1) &&
-                        value < grid.at(x, y + 1)) {
-                        // Found a low point
-                        sum_of_low_point_risk += 1 + value;
-                        basin_sizes.emplace_back(basin_size_for_low_point(grid, x, y));
+            // Shared by every basin's search, so that each cell counts toward the first basin (in row order) whose
+            // rising search reaches it. The puzzle promises that every cell is in exactly one basin, where this changes
+            // nothing; on generated inputs a cell on a ridge between two low points is no longer counted in both.
+            auto visited = grid.like<uint8_t>();
+
+            for (size_t y = 0; y < grid.height(); ++y) {
+                for (size_t x = 0; x < grid.width(); ++x) {
+                    if (low_points.at(x, y)) {
+                        sum_of_low_point_risk += 1 + grid.at(x, y);
+                        basin_sizes.emplace_back(basin_size_for_low_point(grid, visited, grid.index(x, y), arena()));
                     }
                 }
             }
@@ -96,36 +87,31 @@ namespace Year2021::Day9 {
         }
 
       private:
-        static size_t basin_size_for_low_point(const HeightMapGrid &grid, size_t x, size_t y) {
+        static size_t basin_size_for_low_point(const HeightMapGrid &grid,
+                                               HeightMapGrid &visited,
+                                               size_t low_point,
+                                               std::pmr::memory_resource *memory) {
             auto basin_size = size_t{};
-            auto visited = std::vector<bool>(grid.width() * grid.height(), false);
-            auto to_visit = std::deque<std::pair<size_t, size_t>>{{x, y}};
-
-            auto add_to_queue = [&](uint8_t value, size_t other_x, size_t other_y) {
-                const auto other_value = grid.at(other_x, other_y);
-                if (value < other_value && other_value != 9) {
-                    to_visit.emplace_back(other_x, other_y);
-                }
-            };
+            auto to_visit = std::pmr::deque<size_t>{{low_point}, memory};
 
             while (!to_visit.empty()) {
-                const auto &point = to_visit.front();
-                const auto px = point.first;
-                const auto py = point.second;
-                const auto value = grid.at(px, py);
-
-                if (!visited[grid.unique_idx(px, py)]) {
-                    add_to_queue(value, px - 1, py); // left
-                    add_to_queue(value, px + 1, py); // right
-                    add_to_queue(value, px, py - 1); // above
-                    add_to_queue(value, px, py + 1); // below
-
-                    visited[grid.unique_idx(px, py)] = true;
-                    ++basin_size;
+                const auto i = to_visit.front();
+                to_visit.pop_front();
+                if (visited[i]) {
                     continue;
                 }
 
-                to_visit.pop_front();
+                const auto value = grid[i];
+                for (const auto offset : grid.offsets_4()) {
+                    const auto neighbour = static_cast<size_t>(static_cast<ptrdiff_t>(i) + offset);
+                    const auto neighbour_value = grid[neighbour];
+                    if (value < neighbour_value && neighbour_value != EDGE_HEIGHT) {
+                        to_visit.emplace_back(neighbour);
+                    }
+                }
+
+                visited[i] = true;
+                ++basin_size;
             }
 
             return basin_size;
@@ -133,9 +119,10 @@ namespace Year2021::Day9 {
     };
 } // namespace Year2021::Day9
 
+static const auto registration = Common::Registration<Year2021::Day9::Solver>{2021, 9};
+
+#ifndef AOC_NO_MAIN
 const auto FILENAME = "input.txt";
 
-int main(__attribute__((unused)) int _argc, __attribute__((unused)) char **_argv) {
-    Year2021::Day9::Solver{FILENAME}.print_answers();
-    return 0;
-}
+int main(int argc, char **argv) { return Common::solver_main(registration, argc, argv, FILENAME); }
+#endif
@@ -0,0 +1,124 @@
+#include "alloc_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replacement global operator new/delete that count every heap allocation. Each block carries a header in front of
+// the pointer handed out, recording its size so that unsized deletes can be accounted for too.
+
+namespace {
+    std::atomic<size_t> allocation_count{0};
+    std::atomic<size_t> allocated_bytes{0};
+    std::atomic<size_t> live_bytes{0};
+    std::atomic<size_t> peak_live_bytes{0};
+
+    // Alignment malloc already guarantees. The header is this big, so the pointer after it stays just as aligned.
+    constexpr size_t DEFAULT_ALIGNMENT = alignof(std::max_align_t);
+
+    void record_allocation(size_t size) {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        const auto live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+        auto peak = peak_live_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void *allocate(size_t size, size_t alignment) {
+        const auto header_size = std::max(DEFAULT_ALIGNMENT, alignment);
+
+        auto *const block = static_cast<char *>([&]() {
+            if (alignment <= DEFAULT_ALIGNMENT) {
+                return std::malloc(header_size + size);
+            }
+            // aligned_alloc wants the size to be a multiple of the alignment.
+            return std::aligned_alloc(alignment, (header_size + size + alignment - 1) / alignment * alignment);
+        }());
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        auto *const user = block + header_size;
+        reinterpret_cast<size_t *>(user)[-1] = size;
+        record_allocation(size);
+        return user;
+    }
+
+    void *allocate_or_throw(size_t size, size_t alignment) {
+        auto *const user = allocate(size, alignment);
+        if (user == nullptr) {
+            throw std::bad_alloc{};
+        }
+        return user;
+    }
+
+    void deallocate(void *const user, size_t alignment) {
+        if (user == nullptr) {
+            return;
+        }
+
+        const auto size = static_cast<size_t *>(user)[-1];
+        live_bytes.fetch_sub(size, std::memory_order_relaxed);
+        std::free(static_cast<char *>(user) - std::max(DEFAULT_ALIGNMENT, alignment));
+    }
+} // namespace
+
+namespace Common::AllocTracker {
+    Totals totals() {
+        return Totals{
+            allocation_count.load(std::memory_order_relaxed),
+            allocated_bytes.load(std::memory_order_relaxed),
+            live_bytes.load(std::memory_order_relaxed),
+            peak_live_bytes.load(std::memory_order_relaxed),
+        };
+    }
+
+    void reset_peak() { peak_live_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+} // namespace Common::AllocTracker
+
+void *operator new(size_t size) { return allocate_or_throw(size, DEFAULT_ALIGNMENT); }
+void *operator new[](size_t size) { return allocate_or_throw(size, DEFAULT_ALIGNMENT); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return allocate(size, DEFAULT_ALIGNMENT); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return allocate(size, DEFAULT_ALIGNMENT); }
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *user) noexcept { deallocate(user, DEFAULT_ALIGNMENT); }
+void operator delete[](void *user) noexcept { deallocate(user, DEFAULT_ALIGNMENT); }
+void operator delete(void *user, size_t) noexcept { deallocate(user, DEFAULT_ALIGNMENT); }
+void operator delete[](void *user, size_t) noexcept { deallocate(user, DEFAULT_ALIGNMENT); }
+void operator delete(void *user, const std::nothrow_t &) noexcept { deallocate(user, DEFAULT_ALIGNMENT); }
+void operator delete[](void *user, const std::nothrow_t &) noexcept { deallocate(user, DEFAULT_ALIGNMENT); }
+
+void operator delete(void *user, std::align_val_t alignment) noexcept {
+    deallocate(user, static_cast<size_t>(alignment));
+}
+void operator delete[](void *user, std::align_val_t alignment) noexcept {
+    deallocate(user, static_cast<size_t>(alignment));
+}
+void operator delete(void *user, size_t, std::align_val_t alignment) noexcept {
+    deallocate(user, static_cast<size_t>(alignment));
+}
+void operator delete[](void *user, size_t, std::align_val_t alignment) noexcept {
+    deallocate(user, static_cast<size_t>(alignment));
+}
+void operator delete(void *user, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    deallocate(user, static_cast<size_t>(alignment));
+}
+void operator delete[](void *user, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    deallocate(user, static_cast<size_t>(alignment));
+}
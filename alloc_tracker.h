@@ -0,0 +1,50 @@
+#ifndef _ALLOC_TRACKER_H_
+#define _ALLOC_TRACKER_H_
+
+#include "report.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Common {
+    // Process-wide heap accounting, fed by the replacement operator new/delete in alloc_tracker.cpp. Only linked in
+    // when building with `make ALLOC_TRACKING=1`, which also defines AOC_ALLOC_TRACKING.
+    namespace AllocTracker {
+        struct Totals {
+            size_t count;
+            size_t bytes;
+            size_t live_bytes;
+            size_t peak_live_bytes;
+        };
+
+        Totals totals();
+
+        // Restarts peak tracking from the bytes live right now.
+        void reset_peak();
+    } // namespace AllocTracker
+
+    // Measures the allocations made between start() & stop(). Since the totals are process-wide, anything else
+    // allocating at the same time (e.g. other days under runner --jobs) is counted too.
+    class AllocationMeter {
+      public:
+        void start() {
+            AllocTracker::reset_peak();
+            initial = AllocTracker::totals();
+        }
+
+        // Count & bytes are divided by `runs`; the peak is the highest seen over all of them.
+        Allocations stop(size_t runs = 1) const {
+            const auto current = AllocTracker::totals();
+            return Allocations{
+                (current.count - initial.count) / runs,
+                (current.bytes - initial.bytes) / runs,
+                current.peak_live_bytes - std::min(current.peak_live_bytes, initial.live_bytes),
+            };
+        }
+
+      private:
+        AllocTracker::Totals initial{};
+    };
+} // namespace Common
+
+#endif
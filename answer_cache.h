@@ -0,0 +1,152 @@
+#ifndef _ANSWER_CACHE_H_
+#define _ANSWER_CACHE_H_
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Common {
+    // 64-bit FNV-1a, continuing from `hash` so several pieces can be hashed as one.
+    inline uint64_t content_hash(std::string_view bytes, uint64_t hash = 0xCBF29CE484222325ULL) {
+        for (const auto c : bytes) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+    // On-disk store of answers keyed by the input they were solved from. Each entry is a file named after the hash of
+    // the solver identity, its version & the input bytes, & repeats all but the bytes inside so that a hash
+    // collision can't hand back another solver's (or an older version's) answers.
+    class AnswerCache {
+      public:
+        AnswerCache(std::filesystem::path directory, std::string identity, unsigned version)
+            : directory{std::move(directory)}, identity{std::move(identity)}, version{version} {}
+
+        struct Key {
+            uint64_t hash;
+            size_t input_size;
+        };
+
+        Key key(std::string_view input) const {
+            const auto tag = identity + '\n' + std::to_string(version) + '\n';
+            return Key{content_hash(input, content_hash(tag)), input.size()};
+        }
+
+        // Nothing for a missing, unreadable or mismatched entry, which just means solving again.
+        template <typename Answers> std::optional<Answers> load(const Key &key) const {
+            const auto path = entry_path(key);
+            auto file = std::ifstream{path, std::ios::binary};
+            auto ec = std::error_code{};
+            const auto file_size = std::filesystem::file_size(path, ec);
+            if (!file.is_open() || ec) {
+                return std::nullopt;
+            }
+
+            auto header = std::string{}, stored_identity = std::string{};
+            unsigned stored_version = 0;
+            size_t stored_size = 0, count = 0;
+            if (!std::getline(file, header) || header != HEADER || !std::getline(file, stored_identity) ||
+                !(file >> stored_version >> stored_size >> count) || stored_identity != identity ||
+                stored_version != version || stored_size != key.input_size) {
+                return std::nullopt;
+            }
+
+            auto answers = Answers{};
+            for (size_t i = 0; i < count; ++i) {
+                size_t descriptor_size = 0, value_size = 0;
+                if (!(file >> descriptor_size >> value_size) || file.get() != '\n') {
+                    return std::nullopt;
+                }
+                // The sizes are only as good as the file, so check they fit in what's left of it before allocating.
+                const auto position = static_cast<std::streamoff>(file.tellg());
+                if (position < 0 || static_cast<uintmax_t>(position) > file_size) {
+                    return std::nullopt;
+                }
+                const auto remaining = file_size - static_cast<uintmax_t>(position);
+                if (descriptor_size > remaining || value_size > remaining - descriptor_size) {
+                    return std::nullopt;
+                }
+
+                auto descriptor = std::string(descriptor_size, '\0');
+                auto value = std::string(value_size, '\0');
+                if (!file.read(descriptor.data(), static_cast<std::streamsize>(descriptor_size)) ||
+                    !file.read(value.data(), static_cast<std::streamsize>(value_size))) {
+                    return std::nullopt;
+                }
+
+                auto answer = typename Answers::value_type{std::move(descriptor), {}};
+                if (!parse_value(value, answer.value)) {
+                    return std::nullopt;
+                }
+                answers.emplace_back(std::move(answer));
+            }
+            return answers;
+        }
+
+        // Written to a temporary file & renamed into place, so readers (even other processes) never see half an
+        // entry. Failing to store only costs a future solve, so errors are ignored.
+        template <typename Answers> void store(const Key &key, const Answers &answers) const {
+            auto ec = std::error_code{};
+            std::filesystem::create_directories(directory, ec);
+
+            static auto counter = std::atomic<unsigned>{0};
+            const auto final_path = entry_path(key);
+            auto temporary_path = final_path;
+            temporary_path += ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter++);
+
+            {
+                auto file = std::ofstream{temporary_path, std::ios::binary | std::ios::trunc};
+                file << HEADER << '\n' << identity << '\n' << version << ' ' << key.input_size << ' ' << answers.size();
+                for (const auto &answer : answers) {
+                    auto value = std::ostringstream{};
+                    value << answer.value;
+                    file << '\n' << answer.descriptor.size() << ' ' << value.str().size() << '\n'
+                         << answer.descriptor << value.str();
+                }
+                if (!file.flush()) {
+                    std::filesystem::remove(temporary_path, ec);
+                    return;
+                }
+            }
+
+            std::filesystem::rename(temporary_path, final_path, ec);
+            if (ec) {
+                std::filesystem::remove(temporary_path, ec);
+            }
+        }
+
+      private:
+        static constexpr auto HEADER = "aoc-answers 1";
+
+        const std::filesystem::path directory;
+        const std::string identity;
+        const unsigned version;
+
+        std::filesystem::path entry_path(const Key &key) const {
+            auto name = std::ostringstream{};
+            name << std::hex << std::setw(16) << std::setfill('0') << key.hash << ".answers";
+            return directory / name.str();
+        }
+
+        template <typename T> static bool parse_value(const std::string &str, T &value) {
+            if constexpr (std::is_same_v<T, std::string>) {
+                value = str;
+                return true;
+            } else {
+                auto stream = std::istringstream{str};
+                return static_cast<bool>(stream >> value) && stream.peek() == std::char_traits<char>::eof();
+            }
+        }
+    };
+} // namespace Common
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+
+namespace Common {
+    namespace Detail {
+        // Heap allocations for whatever doesn't fit in an Arena's buffer, counted so that the buffer can grow to fit.
+        class OverflowResource : public std::pmr::memory_resource {
+          public:
+            size_t allocated = 0;
+
+          private:
+            void *do_allocate(size_t bytes, size_t alignment) override {
+                allocated += bytes;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+            void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+        };
+
+        // Serialises use of another resource, for parts solved on several threads at once.
+        class LockedResource : public std::pmr::memory_resource {
+          public:
+            std::pmr::memory_resource *upstream = nullptr;
+
+          private:
+            std::mutex mutex;
+
+            void *do_allocate(size_t bytes, size_t alignment) override {
+                const auto lock = std::lock_guard{mutex};
+                return upstream->allocate(bytes, alignment);
+            }
+            void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+                const auto lock = std::lock_guard{mutex};
+                upstream->deallocate(p, bytes, alignment);
+            }
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+        };
+    } // namespace Detail
+
+    // Bump allocator for the structures a solve builds. Deallocating is a no-op; everything is freed at once by
+    // reset(). The buffer is kept between solves & grows to what the last solve needed, so repeating a solve (as
+    // benchmarks do) doesn't touch the heap at all.
+    class Arena {
+      public:
+        explicit Arena(size_t initial_bytes = 64 * 1024) : buffer_size{initial_bytes} {}
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        // Sets up the resources for a solve. Done before any part runs, so that resource() only ever reads & is safe to
+        // call from several threads at once.
+        void prepare() {
+            if (monotonic) {
+                return;
+            }
+            if (!buffer) {
+                buffer.reset(new std::byte[buffer_size]);
+            }
+            monotonic.emplace(buffer.get(), buffer_size, &overflow);
+            locked.upstream = &*monotonic;
+        }
+
+        // `shared` when allocating from several threads at once. Only valid between prepare() & reset().
+        std::pmr::memory_resource *resource(bool shared) {
+            if (!shared) {
+                return &*monotonic;
+            }
+            return &locked;
+        }
+
+        // Prepares the arena for a solve & resets it when the solve ends, whether it returns or throws.
+        class Scope {
+          public:
+            explicit Scope(Arena &arena) : arena{arena} { arena.prepare(); }
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+            ~Scope() { arena.reset(); }
+
+          private:
+            Arena &arena;
+        };
+
+        // Anything allocated from resource() must be gone by now.
+        void reset() {
+            if (!monotonic) {
+                return;
+            }
+            monotonic.reset();
+            locked.upstream = nullptr;
+            if (overflow.allocated > 0) {
+                buffer_size += overflow.allocated;
+                buffer.reset();
+                overflow.allocated = 0;
+            }
+        }
+
+      private:
+        size_t buffer_size;
+        std::unique_ptr<std::byte[]> buffer;
+        Detail::OverflowResource overflow;
+        std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+        Detail::LockedResource locked;
+    };
+} // namespace Common
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include "benchmark_environment.h"
+#include "options.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Microbenchmarks of single kernels, built per day with `make bench` from the day's bench.cpp. That includes main.cpp
+// (with AOC_NO_MAIN), so it can reach private kernels through a `friend struct Bench;` in the day's classes, & ends
+// with `return Common::bench_main(argc, argv, {...});`.
+namespace Common {
+    // Makes the optimiser assume `value` is read, so that the work producing it can't be dropped.
+    template <typename T> inline void do_not_optimize(const T &value) { asm volatile("" : : "m"(value) : "memory"); }
+
+    // Makes the optimiser assume any memory may have been read or written, e.g. to keep stores to a kernel's output.
+    inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+    struct Microbenchmark {
+        std::string name;
+        // What one call of `batch` processes: `items` kernel calls over `bytes` of input (0 where bytes aren't
+        // meaningful). Batches should take well over a microsecond, so that the clock's overhead doesn't show.
+        size_t items;
+        size_t bytes;
+        // Set up (e.g. generating inputs) before returning this, so that only the kernel gets timed.
+        std::function<void()> batch;
+    };
+
+    namespace Detail {
+        struct MicrobenchmarkTiming {
+            size_t batches;
+            std::chrono::duration<double> median;
+        };
+
+        // Times single batches, after a tenth of `min_time` warming up, until `min_time` has passed & there are at
+        // least 10 of them.
+        inline MicrobenchmarkTiming time_microbenchmark(const Microbenchmark &benchmark,
+                                                        std::chrono::duration<double> min_time) {
+            using Clock = std::chrono::steady_clock;
+
+            const auto warmup_end = Clock::now() + min_time / 10;
+            do {
+                benchmark.batch();
+            } while (Clock::now() < warmup_end);
+
+            auto samples = std::vector<std::chrono::duration<double>>{};
+            const auto end = Clock::now() + min_time;
+            while (samples.size() < 10 || Clock::now() < end) {
+                const auto start = Clock::now();
+                benchmark.batch();
+                samples.emplace_back(Clock::now() - start);
+            }
+
+            const auto middle = samples.begin() + static_cast<ptrdiff_t>(samples.size() / 2);
+            std::nth_element(samples.begin(), middle, samples.end());
+            return MicrobenchmarkTiming{samples.size(), *middle};
+        }
+
+        inline void print_microbenchmark_header(size_t name_width, std::ostream &out) {
+            out << std::left << std::setw(name_width) << "Kernel" << std::right << std::setw(10) << "Batch"
+                << std::setw(12) << "ns/item" << std::setw(14) << "items/s" << std::setw(12) << "MB/s"
+                << std::setw(10) << "Batches" << '\n';
+        }
+
+        inline void print_microbenchmark(const Microbenchmark &benchmark,
+                                         const MicrobenchmarkTiming &timing,
+                                         size_t name_width,
+                                         std::ostream &out) {
+            const auto seconds = timing.median.count();
+            const auto flags = out.flags();
+            out << std::left << std::setw(name_width) << benchmark.name << std::right << std::setw(10)
+                << benchmark.items << std::fixed << std::setprecision(2) << std::setw(12)
+                << seconds * 1e9 / static_cast<double>(benchmark.items) << std::setprecision(0) << std::setw(14)
+                << static_cast<double>(benchmark.items) / seconds << std::setprecision(1) << std::setw(12);
+            if (benchmark.bytes > 0) {
+                out << static_cast<double>(benchmark.bytes) / seconds / 1e6;
+            } else {
+                out << "-";
+            }
+            out << std::setw(10) << timing.batches << '\n';
+            out.flags(flags);
+        }
+    } // namespace Detail
+
+    // Runs the benchmarks whose names contain any of the filter arguments (all of them without any) & prints the median
+    // batch time of each, per item & as throughput.
+    inline int bench_main(int argc, char **argv, const std::vector<Microbenchmark> &benchmarks) {
+        auto min_time = std::chrono::duration<double>{0.5};
+        auto filters = std::vector<std::string_view>{};
+        const auto usage = [&]() {
+            std::cerr << "Usage: " << argv[0] << " [--min-time MS] [--pin-cpu N] [FILTER]...\n";
+            return 1;
+        };
+        for (int i = 1; i < argc; ++i) {
+            const auto arg = std::string_view{argv[i]};
+            const auto has_value = i + 1 < argc;
+            if (arg == "--min-time" && has_value) {
+                const auto milliseconds = Detail::parse_count(argv[++i]);
+                if (!milliseconds || *milliseconds == 0) {
+                    return usage();
+                }
+                min_time = std::chrono::milliseconds{*milliseconds};
+                continue;
+            }
+            if (arg == "--pin-cpu" && has_value) {
+                const auto cpu = Detail::parse_count(argv[++i]);
+                if (!cpu) {
+                    return usage();
+                }
+                try {
+                    pin_to_cpu(*cpu);
+                } catch (const std::exception &e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
+                    return 1;
+                }
+                continue;
+            }
+            filters.emplace_back(arg);
+        }
+
+        auto selected = std::vector<const Microbenchmark *>{};
+        for (const auto &benchmark : benchmarks) {
+            if (filters.empty() || std::any_of(filters.begin(), filters.end(), [&](std::string_view filter) {
+                    return benchmark.name.find(filter) != std::string::npos;
+                })) {
+                selected.emplace_back(&benchmark);
+            }
+        }
+        if (selected.empty()) {
+            std::cerr << "Error: no_matching_benchmarks" << std::endl;
+            return 1;
+        }
+
+        auto name_width = size_t{6};
+        for (const auto *const benchmark : selected) {
+            name_width = std::max(name_width, benchmark->name.size());
+        }
+        name_width += 2;
+        Detail::print_microbenchmark_header(name_width, std::cout);
+        for (const auto *const benchmark : selected) {
+            const auto timing = Detail::time_microbenchmark(*benchmark, min_time);
+            Detail::print_microbenchmark(*benchmark, timing, name_width, std::cout);
+        }
+        return 0;
+    }
+} // namespace Common
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef _BENCHMARK_ENVIRONMENT_H_
+#define _BENCHMARK_ENVIRONMENT_H_
+
+#include "options.h"
+#include "report.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Common {
+    namespace Detail {
+        inline std::string read_first_line(const std::filesystem::path &path) {
+            auto file = std::ifstream{path};
+            auto line = std::string{};
+            std::getline(file, line);
+            return line;
+        }
+
+        inline std::string cpu_model() {
+            auto cpuinfo = std::ifstream{"/proc/cpuinfo"};
+            for (auto line = std::string{}; std::getline(cpuinfo, line);) {
+                if (line.starts_with("model name")) {
+                    const auto colon = line.find(':');
+                    return colon == std::string::npos ? line : line.substr(line.find_first_not_of(' ', colon + 1));
+                }
+            }
+            return "unknown";
+        }
+
+        inline std::string frequency_governor(unsigned cpu) {
+            const auto governor = read_first_line("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                                                  "/cpufreq/scaling_governor");
+            return governor.empty() ? "unknown" : governor;
+        }
+
+        inline unsigned current_cpu() {
+#ifdef __linux__
+            const auto cpu = ::sched_getcpu();
+            return cpu < 0 ? 0 : static_cast<unsigned>(cpu);
+#else
+            return 0;
+#endif
+        }
+
+        // Largest of the caches sysfs lists for CPU 0, e.g. "32768K".
+        inline size_t last_level_cache_bytes() {
+            auto largest = size_t{0};
+            const auto caches = std::filesystem::path{"/sys/devices/system/cpu/cpu0/cache"};
+            auto ec = std::error_code{};
+            for (const auto &entry : std::filesystem::directory_iterator{caches, ec}) {
+                const auto size = read_first_line(entry.path() / "size");
+                if (size.empty()) {
+                    continue;
+                }
+                auto bytes = size_t{0};
+                try {
+                    bytes = std::stoull(size);
+                } catch (const std::exception &) {
+                    continue;
+                }
+                bytes *= size.back() == 'K' ? 1024 : size.back() == 'M' ? 1024 * 1024 : 1;
+                largest = std::max(largest, bytes);
+            }
+            return largest > 0 ? largest : 32 * 1024 * 1024;
+        }
+    } // namespace Detail
+
+    // Pins the calling thread (& any it starts later) to `cpu`.
+    inline void pin_to_cpu(size_t cpu) {
+#ifdef __linux__
+        // CPU_SET can't represent (& is undefined for) CPUs past the end of a cpu_set_t.
+        if (cpu >= CPU_SETSIZE) {
+            throw std::runtime_error{"pin_cpu_out_of_range"};
+        }
+        auto set = cpu_set_t{};
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (::sched_setaffinity(0, sizeof(set), &set) != 0) {
+            throw std::runtime_error{"pin_cpu_failed"};
+        }
+#else
+        static_cast<void>(cpu);
+        throw std::runtime_error{"pin_cpu_not_supported"};
+#endif
+    }
+
+    // Lowers the calling thread's nice value as far as RLIMIT_NICE (or CAP_SYS_NICE) allows. False if it couldn't be
+    // lowered at all.
+    inline bool raise_priority() {
+#ifdef __linux__
+        errno = 0;
+        const auto current = ::getpriority(PRIO_PROCESS, 0);
+        if (errno != 0) {
+            return false;
+        }
+
+        auto limit = rlimit{};
+        const auto lowest_allowed = ::getrlimit(RLIMIT_NICE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY
+            ? 20 - static_cast<int>(limit.rlim_cur)
+            : -20;
+        // Root can go below RLIMIT_NICE, so try the lowest value first.
+        for (const auto nice : {-20, lowest_allowed}) {
+            if (nice < current && ::setpriority(PRIO_PROCESS, 0, nice) == 0) {
+                return true;
+            }
+        }
+#endif
+        return false;
+    }
+
+    // Evicts the caches (up to the last level) by streaming through a buffer twice the size of the largest one, for
+    // timing solves as if from cold.
+    class CacheEvictor {
+      public:
+        explicit CacheEvictor(size_t bytes = 2 * Detail::last_level_cache_bytes()) : buffer(bytes, 1) {}
+
+        void evict() {
+            // A write to every line, so that dirty lines of the solve get written back too.
+            for (size_t i = 0; i < buffer.size(); i += 64) {
+                ++buffer[i];
+            }
+        }
+
+      private:
+        std::vector<uint8_t> buffer;
+    };
+
+    // Applies the --pin-cpu & --high-priority switches to the calling thread & describes the machine the benchmark
+    // will run on.
+    inline BenchmarkEnvironment prepare_benchmark_environment(const Options &options) {
+        auto environment = BenchmarkEnvironment{};
+        if (options.pin_cpu) {
+            pin_to_cpu(*options.pin_cpu);
+            environment.pinned_cpu = static_cast<unsigned>(*options.pin_cpu);
+        }
+        if (options.high_priority) {
+            environment.priority_raised = raise_priority();
+        }
+        environment.cold_cache = options.cold_cache;
+        environment.cpu_model = Detail::cpu_model();
+        environment.governor = Detail::frequency_governor(environment.pinned_cpu.value_or(Detail::current_cpu()));
+        return environment;
+    }
+} // namespace Common
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef _GRID_H_
+#define _GRID_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace Common {
+    namespace Detail {
+        inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+        template <typename T> struct CacheAlignedAllocator {
+            using value_type = T;
+
+            CacheAlignedAllocator() = default;
+            template <typename U> CacheAlignedAllocator(const CacheAlignedAllocator<U> &) {}
+
+            T *allocate(size_t n) {
+                return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{CACHE_LINE_SIZE}));
+            }
+            void deallocate(T *p, size_t) { ::operator delete(p, std::align_val_t{CACHE_LINE_SIZE}); }
+
+            template <typename U> bool operator==(const CacheAlignedAllocator<U> &) const { return true; }
+        };
+    } // namespace Detail
+
+    // Row-major 2D grid with `halo` extra cells around every side, so that the neighbours of any cell can be read
+    // without bounds checks: fill the halo with a value that the day's rules ignore (e.g. height 9, or "visited").
+    // Rows start on cache line boundaries, & the map helpers below run over whole rows without branches so that the
+    // compiler can vectorise them.
+    //
+    // x & y are interior coordinates, the halo being at -halo..-1 & width..width+halo-1. Flat indices (index()) are
+    // what neighbour offsets (offset(), offsets_4/8()) apply to.
+    template <typename T> class Grid {
+      public:
+        Grid() = default;
+
+        Grid(size_t width, size_t height, size_t halo = 1, T fill = T{})
+            : Grid{width, height, halo, fill, aligned_stride(width + 2 * halo)} {}
+
+        // Rows of decimal digits, one line each (ending in LF or CRLF) & all the same length, as their values 0-9.
+        static Grid parse_digits(std::string_view input, size_t halo = 1, T halo_value = T{}) {
+            while (!input.empty() && input.back() == '\n') {
+                input.remove_suffix(1);
+                if (!input.empty() && input.back() == '\r') {
+                    input.remove_suffix(1);
+                }
+            }
+            if (input.empty()) {
+                throw std::runtime_error{"malformed_input"};
+            }
+
+            auto width = input.find('\n');
+            width = width == std::string_view::npos ? input.size() : width;
+            const auto has_cr = width > 0 && input[width - 1] == '\r';
+            // Including the line ending, which the last line (with its ending stripped above) lacks.
+            const auto line_length = width + 1;
+            width -= has_cr;
+
+            if ((input.size() + 1 + has_cr) % line_length != 0) {
+                throw std::runtime_error{"malformed_input"};
+            }
+            const auto height = (input.size() + 1 + has_cr) / line_length;
+
+            auto grid = Grid{width, height, halo, halo_value};
+            auto bad = uint8_t{0};
+            for (size_t y = 0; y < height; ++y) {
+                const auto line = input.substr(y * line_length, line_length);
+                auto *const out = grid.row(y);
+                for (size_t x = 0; x < width; ++x) {
+                    const auto digit = static_cast<uint8_t>(line[x] - '0');
+                    bad |= digit > 9;
+                    out[x] = static_cast<T>(digit);
+                }
+                bad |= y + 1 < height && (line[line_length - 1] != '\n' || (has_cr && line[width] != '\r'));
+            }
+            if (bad) {
+                throw std::runtime_error{"malformed_input"};
+            }
+            return grid;
+        }
+
+        size_t width() const { return w; }
+        size_t height() const { return h; }
+        size_t halo() const { return halo_size; }
+        // Cells from one row to the next.
+        size_t stride() const { return row_stride; }
+
+        size_t index(size_t x, size_t y) const { return (y + halo_size) * row_stride + x + halo_size; }
+        ptrdiff_t offset(ptrdiff_t dx, ptrdiff_t dy) const {
+            return dy * static_cast<ptrdiff_t>(row_stride) + dx;
+        }
+
+        T &operator[](size_t i) { return cells[i]; }
+        const T &operator[](size_t i) const { return cells[i]; }
+        T &at(size_t x, size_t y) { return cells[index(x, y)]; }
+        const T &at(size_t x, size_t y) const { return cells[index(x, y)]; }
+
+        // First interior cell of row y; row(-1) etc. reach into the halo.
+        T *row(ptrdiff_t y) { return cells.data() + index(0, 0) + y * static_cast<ptrdiff_t>(row_stride); }
+        const T *row(ptrdiff_t y) const {
+            return cells.data() + index(0, 0) + y * static_cast<ptrdiff_t>(row_stride);
+        }
+
+        // Sets every interior cell, leaving the halo alone.
+        void fill(T value) {
+            for (size_t y = 0; y < h; ++y) {
+                std::fill(row(y), row(y) + w, value);
+            }
+        }
+
+        // Same shape & stride, so that flat indices & offsets carry over, with every cell (halo included) set to
+        // `value`.
+        template <typename U> Grid<U> like(U value = U{}) const { return Grid<U>{w, h, halo_size, value, row_stride}; }
+
+        // N, W, E, S & then the diagonals NW, NE, SW, SE, as flat index offsets.
+        std::array<ptrdiff_t, 4> offsets_4() const {
+            return {offset(0, -1), offset(-1, 0), offset(1, 0), offset(0, 1)};
+        }
+        std::array<ptrdiff_t, 8> offsets_8() const {
+            return {offset(0, -1),
+                    offset(-1, 0),
+                    offset(1, 0),
+                    offset(0, 1),
+                    offset(-1, -1),
+                    offset(1, -1),
+                    offset(-1, 1),
+                    offset(1, 1)};
+        }
+
+        // Sets every interior cell of `out` (of the same shape) to f(centre, n, w, e, s) of the same cell here. Needs a
+        // halo.
+        template <typename U, typename F> void map_4(Grid<U> &out, F f) const {
+            for (size_t y = 0; y < h; ++y) {
+                const T *const north = row(static_cast<ptrdiff_t>(y) - 1);
+                const T *const centre = row(y);
+                const T *const south = row(y + 1);
+                U *const result = out.row(y);
+                for (size_t x = 0; x < w; ++x) {
+                    result[x] = f(centre[x], north[x], (centre - 1)[x], (centre + 1)[x], south[x]);
+                }
+            }
+        }
+
+        // As map_4, with f(centre, n, w, e, s, nw, ne, sw, se).
+        template <typename U, typename F> void map_8(Grid<U> &out, F f) const {
+            for (size_t y = 0; y < h; ++y) {
+                const T *const north = row(static_cast<ptrdiff_t>(y) - 1);
+                const T *const centre = row(y);
+                const T *const south = row(y + 1);
+                U *const result = out.row(y);
+                for (size_t x = 0; x < w; ++x) {
+                    result[x] = f(centre[x],
+                                  north[x],
+                                  (centre - 1)[x],
+                                  (centre + 1)[x],
+                                  south[x],
+                                  (north - 1)[x],
+                                  (north + 1)[x],
+                                  (south - 1)[x],
+                                  (south + 1)[x]);
+                }
+            }
+        }
+
+      private:
+        template <typename> friend class Grid;
+
+        Grid(size_t width, size_t height, size_t halo, T fill, size_t stride)
+            : w{width}, h{height}, halo_size{halo}, row_stride{stride}, cells((height + 2 * halo) * stride, fill) {}
+
+        size_t w = 0;
+        size_t h = 0;
+        size_t halo_size = 0;
+        size_t row_stride = 0;
+        std::vector<T, Detail::CacheAlignedAllocator<T>> cells;
+
+        static size_t aligned_stride(size_t cells_per_row) {
+            const auto bytes = cells_per_row * sizeof(T);
+            const auto aligned_bytes =
+                (bytes + Detail::CACHE_LINE_SIZE - 1) / Detail::CACHE_LINE_SIZE * Detail::CACHE_LINE_SIZE;
+            return aligned_bytes % sizeof(T) == 0 ? aligned_bytes / sizeof(T) : cells_per_row;
+        }
+    };
+} // namespace Common
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef _INCREMENTAL_H_
+#define _INCREMENTAL_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Common {
+    template <typename T> class Solver;
+
+    // Longest line `--stream` will hold on to while waiting for the rest of it, so that following a log that never
+    // ends can't grow without bound. A day's solve() takes lines of any length.
+    inline constexpr size_t STREAM_MAX_RECORD_SIZE = 4096;
+
+    // Puts delimited records back together from chunks of input cut anywhere, holding on to at most one incomplete
+    // record between chunks. Records longer than `max_record_size` bytes throw, wherever they fall in the input.
+    class RecordSplitter {
+      public:
+        constexpr explicit RecordSplitter(char delimiter = '\n',
+                                          size_t max_record_size = std::numeric_limits<size_t>::max())
+            : delimiter{delimiter}, max_record_size{max_record_size} {}
+
+        // Only for before the first feed().
+        constexpr void limit(size_t record_size) { max_record_size = record_size; }
+
+        // Calls on_record(std::string_view) for every record the chunk completes. Views are only valid during the call.
+        template <typename F> constexpr void feed(std::string_view chunk, F &&on_record) {
+            if (!partial.empty()) {
+                const auto end = chunk.find(delimiter);
+                keep(chunk.substr(0, end));
+                if (end == std::string_view::npos) {
+                    return;
+                }
+                on_record(std::string_view{partial});
+                partial.clear();
+                chunk.remove_prefix(end + 1);
+            }
+
+            for (auto end = chunk.find(delimiter); end != std::string_view::npos; end = chunk.find(delimiter)) {
+                check(end);
+                on_record(chunk.substr(0, end));
+                chunk.remove_prefix(end + 1);
+            }
+            keep(chunk);
+        }
+
+        // The input has ended, so whatever's left is the last record (which didn't have a delimiter).
+        template <typename F> constexpr void finish(F &&on_record) {
+            if (!partial.empty()) {
+                on_record(std::string_view{partial});
+                partial.clear();
+            }
+        }
+
+      private:
+        char delimiter;
+        size_t max_record_size;
+        std::string partial;
+
+        constexpr void check(size_t record_size) const {
+            if (record_size > max_record_size) {
+                throw std::runtime_error{"record_too_long"};
+            }
+        }
+
+        constexpr void keep(std::string_view start_of_record) {
+            check(partial.size() + start_of_record.size());
+            partial.append(start_of_record);
+        }
+    };
+
+    // For days that fold over their input in a single pass: takes the input a chunk at a time, in memory that doesn't
+    // grow with it, & can give the answers so far at any point. So a log that's still being written (or never ends)
+    // can be followed with `--stream` without ever re-reading it.
+    template <typename T> class IncrementalSolver {
+      public:
+        using Answers = typename Solver<T>::Answers;
+
+        virtual ~IncrementalSolver() = default;
+
+        // The next piece of input, which can end anywhere, even mid record.
+        virtual void feed(std::string_view chunk) = 0;
+
+        // Answers for the input fed so far, ignoring any incomplete last record.
+        virtual Answers snapshot() const = 0;
+
+        // Ends the input & returns the final answers.
+        virtual Answers finish() = 0;
+
+        // Makes feed() throw on records longer than `max_record_size` bytes; only for before the first feed(). Solvers
+        // that don't hold on to partial records needn't override it.
+        virtual void limit_record_size(__attribute__((unused)) size_t max_record_size) {}
+
+        // All of `input` in one go, for a day's solve().
+        Answers solve(std::istream &input) {
+            auto buffer = std::vector<char>(64 * 1024);
+            while (input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0) {
+                feed(std::string_view{buffer.data(), static_cast<size_t>(input.gcount())});
+            }
+            return finish();
+        }
+
+        Answers solve(std::string_view input) {
+            feed(input);
+            return finish();
+        }
+    };
+
+    // An IncrementalSolver over '\n' separated records, which it hands to `fold.add(std::string_view)`; the day's
+    // `Fold` also provides `Answers answers() const`.
+    template <typename T, typename Fold> class RecordFoldSolver : public IncrementalSolver<T> {
+      public:
+        using Answers = typename IncrementalSolver<T>::Answers;
+
+        void feed(std::string_view chunk) override {
+            records.feed(chunk, [&](std::string_view record) { fold.add(record); });
+        }
+
+        void limit_record_size(size_t max_record_size) override { records.limit(max_record_size); }
+
+        Answers snapshot() const override { return fold.answers(); }
+
+        Answers finish() override {
+            records.finish([&](std::string_view record) { fold.add(record); });
+            return fold.answers();
+        }
+
+      private:
+        RecordSplitter records;
+        Fold fold;
+    };
+
+    // Solvers that provide `using Incremental = ...;`, an IncrementalSolver that can be default constructed.
+    template <typename S>
+    concept HasIncrementalSolver = requires {
+        typename S::Incremental;
+    };
+
+    namespace Detail {
+        // Reads `path` as its data arrives (so a pipe or a file still being written gets fed what's there so far),
+        // calling on_chunk(std::string_view) for every read.
+        template <typename F> void read_chunks(const std::string &path, F &&on_chunk) {
+            const auto fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1) {
+                throw std::runtime_error{"file_open_failed"};
+            }
+
+            char chunk[1 << 16];
+            while (true) {
+                const auto read_count = ::read(fd, chunk, sizeof(chunk));
+                if (read_count == 0) {
+                    break;
+                }
+                if (read_count < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    ::close(fd);
+                    throw std::runtime_error{"file_read_failed"};
+                }
+                try {
+                    on_chunk(std::string_view{chunk, static_cast<size_t>(read_count)});
+                } catch (...) {
+                    ::close(fd);
+                    throw;
+                }
+            }
+            ::close(fd);
+        }
+    } // namespace Detail
+} // namespace Common
+
+#endif
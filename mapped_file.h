@@ -0,0 +1,93 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace Common {
+    // Read-only view over the entire contents of a file. Regular files are mmap'd so parsing reads straight out of the
+    // page cache; anything that can't be mapped (pipes, character devices, empty files) is read into an owned buffer
+    // instead so callers only ever deal with a string_view.
+    class MappedFile {
+      public:
+        explicit MappedFile(const std::string &path) {
+            const auto fd = ::open(path.c_str(), O_RDONLY);
+            if (fd == -1) {
+                throw std::runtime_error{"file_open_failed"};
+            }
+
+            struct stat file_stat {};
+            if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+                const auto length = static_cast<size_t>(file_stat.st_size);
+                const auto address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED) {
+                    ::madvise(address, length, MADV_SEQUENTIAL);
+                    mapping = address;
+                    mapping_length = length;
+                }
+            }
+
+            if (mapping == nullptr && !read_all(fd)) {
+                ::close(fd);
+                throw std::runtime_error{"file_read_failed"};
+            }
+
+            ::close(fd);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept
+            : mapping{other.mapping}, mapping_length{other.mapping_length}, buffer{std::move(other.buffer)} {
+            other.mapping = nullptr;
+            other.mapping_length = 0;
+        }
+        MappedFile &operator=(MappedFile &&) = delete;
+
+        ~MappedFile() {
+            if (mapping != nullptr) {
+                ::munmap(mapping, mapping_length);
+            }
+        }
+
+        std::string_view view() const {
+            if (mapping != nullptr) {
+                return std::string_view{static_cast<const char *>(mapping), mapping_length};
+            }
+            return std::string_view{buffer};
+        }
+
+      private:
+        void *mapping = nullptr;
+        size_t mapping_length = 0;
+        std::string buffer;
+
+        bool read_all(int fd) {
+            char chunk[1 << 16];
+            while (true) {
+                const auto read_count = ::read(fd, chunk, sizeof(chunk));
+                if (read_count == 0) {
+                    return true;
+                }
+                if (read_count < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                buffer.append(chunk, static_cast<size_t>(read_count));
+            }
+        }
+    };
+} // namespace Common
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef _MEMORY_USAGE_H_
+#define _MEMORY_USAGE_H_
+
+#include "report.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Common {
+    namespace Detail {
+        // Reads a "Name:   1234 kB" line out of /proc/self/status.
+        inline std::optional<size_t> read_proc_status_kib(std::string_view name) {
+            auto status = std::ifstream{"/proc/self/status"};
+            for (auto line = std::string{}; std::getline(status, line);) {
+                if (line.starts_with(name) && line.size() > name.size() && line[name.size()] == ':') {
+                    return std::stoul(line.substr(name.size() + 1));
+                }
+            }
+            return std::nullopt;
+        }
+
+        inline size_t current_rss_kib() { return read_proc_status_kib("VmRSS").value_or(0); }
+
+        inline size_t peak_rss_kib() {
+            if (const auto hwm = read_proc_status_kib("VmHWM")) {
+                return *hwm;
+            }
+            // ru_maxrss is in KiB on Linux.
+            auto usage = rusage{};
+            ::getrusage(RUSAGE_SELF, &usage);
+            return static_cast<size_t>(usage.ru_maxrss);
+        }
+
+        // Resets VmHWM to the current RSS (Linux 4.0+). Returns false where that isn't possible, leaving the
+        // process lifetime peak in place.
+        inline bool reset_peak_rss() {
+            auto clear_refs = std::ofstream{"/proc/self/clear_refs"};
+            clear_refs << "5";
+            clear_refs.flush();
+            return clear_refs.good();
+        }
+    } // namespace Detail
+
+    // Measures the resident set high-water mark over a solve & how much of it the solve added on top of what was
+    // resident when it started. RSS is per process, so it's only measured (enabled) when nothing else solves alongside;
+    // otherwise each solve's reset of the peak would clobber the others'.
+    class MemoryMeter {
+      public:
+        explicit MemoryMeter(bool enabled) : enabled{enabled} {}
+
+        void start() {
+            if (!enabled) {
+                return;
+            }
+            Detail::reset_peak_rss();
+            initial_rss_kib = Detail::current_rss_kib();
+        }
+
+        std::optional<MemoryUsage> stop() const {
+            if (!enabled) {
+                return std::nullopt;
+            }
+            const auto peak = Detail::peak_rss_kib();
+            return MemoryUsage{peak, peak - std::min(peak, initial_rss_kib)};
+        }
+
+      private:
+        bool enabled;
+        size_t initial_rss_kib = 0;
+    };
+} // namespace Common
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef _OPTIONS_H_
+#define _OPTIONS_H_
+
+#include <charconv>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Common {
+    // Command line switches understood by every solver binary.
+    struct Options {
+        struct {
+            size_t iterations;
+            std::optional<size_t> warmup;
+        } benchmark;
+
+        // Benchmark isolation, see benchmark_environment.h: the CPU to pin the benchmarking thread to, whether to raise
+        // its scheduling priority, & whether to evict the caches before every timed iteration.
+        std::optional<size_t> pin_cpu;
+        bool high_priority = false;
+        bool cold_cache = false;
+
+        // Worker threads to use, 0 meaning one per core.
+        size_t jobs = 1;
+
+        // Let solvers evaluate their independent parts on separate threads.
+        bool concurrent_parts = false;
+
+        // Collect hardware performance counters around each solve.
+        bool perf_counters = false;
+
+        // Fail a solve whose resident set grows by more than this many KiB.
+        std::optional<size_t> memory_budget_kib;
+
+        // Write each report as a JSON line (see results.h) instead of text.
+        bool json = false;
+
+        // Results file (JSON lines) to compare benchmark timings against, & the slowdown in percent that counts as a
+        // regression when it's also statistically significant.
+        std::optional<std::string> compare_baseline;
+        size_t regression_threshold_percent = 5;
+
+        // Solve generated inputs of growing size & report how the time scales, instead of solving input.txt.
+        struct {
+            bool enabled = false;
+            size_t max_scale = 1000;
+            uint64_t seed = 1;
+        } scaling;
+
+        // Directory of answers kept from earlier solves, looked up by input content before solving.
+        std::optional<std::string> cache_dir;
+
+        // Directory of parsed inputs kept from earlier solves (see snapshot.h), loaded instead of parsing again.
+        std::optional<std::string> snapshot_dir;
+
+        // Where to write a Chrome trace of the solves' spans, see trace.h. Only in builds with AOC_TRACE.
+        std::optional<std::string> trace_file;
+
+        // File listing input paths to solve, one per line.
+        std::optional<std::string> input_list;
+
+        // Solve all the inputs across `jobs` threads & report inputs/s & latency percentiles rather than each solve.
+        bool throughput = false;
+
+        // Feed the inputs to the day's incremental solver as they're read, printing the answers so far at most this
+        // often (in milliseconds) & the final ones at the end, see incremental.h.
+        std::optional<size_t> stream_interval_ms;
+
+        // Arguments that aren't switches, left for the binary to interpret.
+        std::vector<std::string> positional;
+    };
+
+    namespace Detail {
+        inline std::optional<size_t> parse_count(const char *const str) {
+            const auto view = std::string_view{str};
+            size_t count = 0;
+            auto [ptr, err] = std::from_chars(view.data(), view.data() + view.size(), count);
+            if (err != std::errc{} || ptr != view.data() + view.size()) {
+                return std::nullopt;
+            }
+            return count;
+        }
+    } // namespace Detail
+
+    // Returns nullopt if the arguments couldn't be understood.
+    inline std::optional<Options> parse_options(int argc, char **argv) {
+        auto options = Options{};
+
+        for (int i = 1; i < argc; ++i) {
+            const auto arg = std::string_view{argv[i]};
+            const auto has_value = i + 1 < argc;
+
+            if (arg == "--benchmark" && has_value) {
+                const auto iterations = Detail::parse_count(argv[++i]);
+                if (!iterations || *iterations == 0) {
+                    return std::nullopt;
+                }
+                options.benchmark.iterations = *iterations;
+                continue;
+            }
+
+            if (arg == "--warmup" && has_value) {
+                options.benchmark.warmup = Detail::parse_count(argv[++i]);
+                if (!options.benchmark.warmup) {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            if (arg == "--pin-cpu" && has_value) {
+                options.pin_cpu = Detail::parse_count(argv[++i]);
+                if (!options.pin_cpu) {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            if (arg == "--high-priority") {
+                options.high_priority = true;
+                continue;
+            }
+
+            if (arg == "--cold-cache") {
+                options.cold_cache = true;
+                continue;
+            }
+
+            if (arg == "--concurrent-parts") {
+                options.concurrent_parts = true;
+                continue;
+            }
+
+            if (arg == "--perf") {
+                options.perf_counters = true;
+                continue;
+            }
+
+            if (arg == "--memory-budget" && has_value) {
+                options.memory_budget_kib = Detail::parse_count(argv[++i]);
+                if (!options.memory_budget_kib) {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            if (arg == "--json") {
+                options.json = true;
+                continue;
+            }
+
+            if (arg == "--compare" && has_value) {
+                options.compare_baseline = argv[++i];
+                continue;
+            }
+
+            if (arg == "--threshold" && has_value) {
+                const auto threshold = Detail::parse_count(argv[++i]);
+                if (!threshold) {
+                    return std::nullopt;
+                }
+                options.regression_threshold_percent = *threshold;
+                continue;
+            }
+
+            if (arg == "--scaling") {
+                options.scaling.enabled = true;
+                continue;
+            }
+
+            if (arg == "--max-scale" && has_value) {
+                const auto max_scale = Detail::parse_count(argv[++i]);
+                if (!max_scale || *max_scale == 0) {
+                    return std::nullopt;
+                }
+                options.scaling.max_scale = *max_scale;
+                continue;
+            }
+
+            if (arg == "--seed" && has_value) {
+                const auto seed = Detail::parse_count(argv[++i]);
+                if (!seed) {
+                    return std::nullopt;
+                }
+                options.scaling.seed = *seed;
+                continue;
+            }
+
+            if (arg == "--cache" && has_value) {
+                options.cache_dir = argv[++i];
+                continue;
+            }
+
+            if (arg == "--snapshot" && has_value) {
+                options.snapshot_dir = argv[++i];
+                continue;
+            }
+
+#ifdef AOC_TRACE
+            if (arg == "--trace" && has_value) {
+                options.trace_file = argv[++i];
+                continue;
+            }
+#endif
+
+            if (arg == "--inputs" && has_value) {
+                options.input_list = argv[++i];
+                continue;
+            }
+
+            if (arg == "--throughput") {
+                options.throughput = true;
+                continue;
+            }
+
+            if (arg == "--stream" && has_value) {
+                options.stream_interval_ms = Detail::parse_count(argv[++i]);
+                if (!options.stream_interval_ms) {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            if (arg == "--jobs" && has_value) {
+                const auto jobs = Detail::parse_count(argv[++i]);
+                if (!jobs) {
+                    return std::nullopt;
+                }
+                options.jobs = *jobs;
+                continue;
+            }
+
+            if (arg.starts_with("--")) {
+                return std::nullopt;
+            }
+
+            options.positional.emplace_back(arg);
+        }
+
+        // Only benchmarks have the statistics to compare, or are isolated.
+        if ((options.compare_baseline || options.pin_cpu || options.high_priority || options.cold_cache) &&
+            options.benchmark.iterations == 0) {
+            return std::nullopt;
+        }
+
+        // Throughput is measured over single solves.
+        if (options.throughput && options.benchmark.iterations > 0) {
+            return std::nullopt;
+        }
+
+        // RSS is per process, so there'd be no telling which of the solves running alongside grew it.
+        if (options.memory_budget_kib && (options.jobs != 1 || options.throughput)) {
+            return std::nullopt;
+        }
+
+        // Streamed inputs are solved once, as they arrive.
+        if (options.stream_interval_ms && (options.benchmark.iterations > 0 || options.throughput)) {
+            return std::nullopt;
+        }
+
+        return options;
+    }
+
+    inline void print_usage(const char *const program, const char *const arguments = "[INPUT | -]...") {
+        std::cerr << "Usage: " << program << " [options] " << arguments << "\n"
+                  << "  --benchmark N    Solve N times against input loaded once & report timing statistics\n"
+                  << "  --warmup N       Untimed solves before benchmarking (default: N/10 of --benchmark)\n"
+                  << "  --pin-cpu N      Pin benchmarks to CPU N\n"
+                  << "  --high-priority  Run benchmarks at the highest scheduling priority allowed\n"
+                  << "  --cold-cache     Evict the CPU caches before every timed benchmark iteration (default: warm)\n"
+                  << "  --jobs N         Run independent work on N threads, 0 for one per core (default: 1)\n"
+                  << "  --concurrent-parts\n"
+                  << "                   Solve each part on its own thread where a solver supports it\n"
+                  << "  --perf           Report hardware performance counters (cycles, cache misses, ...) per solve\n"
+                  << "  --memory-budget KIB\n"
+                  << "                   Fail if a solve grows the resident set by more than KIB KiB (not with --jobs\n"
+                  << "                   or --throughput, which don't report peak RSS either)\n"
+                  << "  --json           Write results as JSON lines\n"
+                  << "  --compare FILE   Compare --benchmark timings with a file saved from --json & fail on\n"
+                  << "                   regressions\n"
+                  << "  --threshold PCT  Slowdown that --compare treats as a regression when significant (default: 5)\n"
+                  << "  --scaling        Solve generated inputs at 1x, 10x, 100x... & fit how the time grows\n"
+                  << "  --max-scale N    Largest --scaling factor (default: 1000)\n"
+                  << "  --seed N         Seed for generated inputs (default: 1)\n"
+                  << "  --cache DIR      Reuse answers stored in DIR for inputs solved before, storing new ones there\n"
+                  << "  --snapshot DIR   Load parsed inputs saved in DIR instead of parsing, saving new ones there\n"
+                  << "  --inputs FILE    Also solve every input listed (one path per line) in FILE, - for stdin\n"
+                  << "  --throughput     Solve all the inputs on --jobs threads & report inputs/s & latency\n"
+                  << "                   percentiles\n"
+                  << "  --stream MS      Feed the inputs to the solver as they're read (e.g. - for a log that's still\n"
+                  << "                   being written), printing the answers so far at most every MS milliseconds\n";
+#ifdef AOC_TRACE
+        std::cerr << "  --trace FILE     Write a Chrome trace of the solves' spans (see trace.h) to FILE\n";
+#endif
+    }
+} // namespace Common
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef _PERF_COUNTERS_H_
+#define _PERF_COUNTERS_H_
+
+#include "report.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+#ifdef __linux__
+    namespace Detail {
+        struct PerfEvent {
+            const char *name;
+            uint32_t type;
+            uint64_t config;
+        };
+
+        // Config for the read misses of one of the generic cache events.
+        constexpr uint64_t read_misses(uint64_t cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+
+        inline constexpr auto PERF_EVENTS = std::array<PerfEvent, 6>{
+            PerfEvent{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            PerfEvent{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            PerfEvent{"L1d read misses", PERF_TYPE_HW_CACHE, read_misses(PERF_COUNT_HW_CACHE_L1D)},
+            PerfEvent{"LLC read misses", PERF_TYPE_HW_CACHE, read_misses(PERF_COUNT_HW_CACHE_LL)},
+            PerfEvent{"branch misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            PerfEvent{"dTLB read misses", PERF_TYPE_HW_CACHE, read_misses(PERF_COUNT_HW_CACHE_DTLB)},
+        };
+    } // namespace Detail
+#endif
+
+    // Hardware performance counters for the calling process (& any threads it starts while counting), via
+    // perf_event_open. Counters the kernel or hardware won't give us (no PMU in a VM, perf_event_paranoid, non-Linux)
+    // are silently left out of the results, so callers just end up with fewer or no counters.
+    class PerfCounters {
+      public:
+        PerfCounters() {
+#ifdef __linux__
+            for (size_t i = 0; i < Detail::PERF_EVENTS.size(); ++i) {
+                auto attr = perf_event_attr{};
+                attr.size = sizeof(attr);
+                attr.type = Detail::PERF_EVENTS[i].type;
+                attr.config = Detail::PERF_EVENTS[i].config;
+                attr.disabled = 1;
+                attr.inherit = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+            }
+#endif
+        }
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        ~PerfCounters() {
+#ifdef __linux__
+            for (const auto fd : fds) {
+                if (fd != -1) {
+                    ::close(fd);
+                }
+            }
+#endif
+        }
+
+        void start() {
+#ifdef __linux__
+            for (const auto fd : fds) {
+                if (fd != -1) {
+                    ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        // Stops & restarts counting without losing the counts so far, to leave out work between solves.
+        void pause() {
+#ifdef __linux__
+            for (const auto fd : fds) {
+                if (fd != -1) {
+                    ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+#endif
+        }
+
+        void resume() {
+#ifdef __linux__
+            for (const auto fd : fds) {
+                if (fd != -1) {
+                    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        // Counts since start(), divided by `runs`. Counts that had to be multiplexed with other events are scaled up
+        // to the full time they were enabled for.
+        Counters stop(size_t runs = 1) {
+            auto counters = Counters{};
+#ifdef __linux__
+            for (const auto fd : fds) {
+                if (fd != -1) {
+                    ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+
+            for (size_t i = 0; i < Detail::PERF_EVENTS.size(); ++i) {
+                struct {
+                    uint64_t value, time_enabled, time_running;
+                } reading{};
+
+                if (fds[i] == -1 || ::read(fds[i], &reading, sizeof(reading)) != sizeof(reading) ||
+                    reading.time_running == 0) {
+                    continue;
+                }
+
+                const auto scale =
+                    static_cast<double>(reading.time_enabled) / static_cast<double>(reading.time_running);
+                const auto value = static_cast<double>(reading.value) * scale / static_cast<double>(runs);
+                counters.emplace_back(Counter{Detail::PERF_EVENTS[i].name, value});
+            }
+#else
+            static_cast<void>(runs);
+#endif
+            return counters;
+        }
+
+      private:
+#ifdef __linux__
+        std::array<int, Detail::PERF_EVENTS.size()> fds{};
+#endif
+    };
+} // namespace Common
+
+#endif
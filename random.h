@@ -0,0 +1,39 @@
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Common {
+    // Small deterministic PRNG (SplitMix64) for input generators, so a given seed produces the same input on every
+    // platform & standard library, unlike the <random> distributions.
+    class Random {
+      public:
+        explicit Random(uint64_t seed) : state{seed} {}
+
+        uint64_t next() {
+            auto z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, n), n > 0.
+        uint64_t below(uint64_t n) { return next() % n; }
+
+        // Uniform in [lo, hi].
+        int64_t between(int64_t lo, int64_t hi) {
+            return lo + static_cast<int64_t>(below(static_cast<uint64_t>(hi - lo) + 1));
+        }
+
+        // True with probability `numerator / denominator`.
+        bool chance(uint64_t numerator, uint64_t denominator) { return below(denominator) < numerator; }
+
+        template <typename T, size_t N> const T &pick(const T (&choices)[N]) { return choices[below(N)]; }
+
+      private:
+        uint64_t state;
+    };
+} // namespace Common
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef _REGISTRY_H_
+#define _REGISTRY_H_
+
+#include "options.h"
+#include "report.h"
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Common {
+    // Type-erased view of a solver, so that solvers with different answer types can be driven uniformly.
+    class Runnable {
+      public:
+        virtual ~Runnable() = default;
+
+        // Applies the command line switches that change how solving happens.
+        virtual void configure(const Options &options) = 0;
+
+        // Points later solves at a different input, keeping everything else the solver holds on to.
+        virtual void set_input(const std::string &input_file_path) = 0;
+
+        virtual Report run() = 0;
+        virtual Report run_benchmark(size_t iterations, size_t warmup) = 0;
+    };
+
+    // Every day registers its solver here (see Registration), which lets a single binary link & run any of them.
+    class Registry {
+      public:
+        using Factory = std::function<std::unique_ptr<Runnable>(const std::string &input_file_path)>;
+        // Produces a valid input roughly `scale` times the size of the real one, the same for a given seed.
+        using Generator = std::function<std::string(size_t scale, uint64_t seed)>;
+
+        struct Entry {
+            unsigned year;
+            unsigned day;
+            Factory make;
+            // Rough idea of how long a solve takes, used to start the slowest days first when running concurrently.
+            std::chrono::milliseconds expected_time;
+            // Empty for days without an input generator.
+            Generator generate;
+        };
+
+        static Registry &instance() {
+            static auto registry = Registry{};
+            return registry;
+        }
+
+        void add(Entry entry) { entries.emplace_back(std::move(entry)); }
+
+        // Ordered by year, then day.
+        std::vector<Entry> all() const {
+            auto sorted = entries;
+            std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+                return std::tie(a.year, a.day) < std::tie(b.year, b.day);
+            });
+            return sorted;
+        }
+
+      private:
+        std::vector<Entry> entries;
+    };
+
+    // Solvers can provide `static std::string generate_input(size_t scale, uint64_t seed)` to make synthetic inputs.
+    template <typename S>
+    concept HasInputGenerator = requires(size_t scale, uint64_t seed) {
+        { S::generate_input(scale, seed) } -> std::convertible_to<std::string>;
+    };
+
+    // Constructing one of these at namespace scope registers solver S for the given year & day.
+    template <typename S> struct Registration {
+        const unsigned year;
+        const unsigned day;
+
+        Registration(unsigned year, unsigned day, std::chrono::milliseconds expected_time = {})
+            : year{year}, day{day} {
+            Registry::instance().add(Registry::Entry{year, day, make, expected_time, generator()});
+        }
+
+        static Registry::Generator generator() {
+            if constexpr (HasInputGenerator<S>) {
+                return &S::generate_input;
+            } else {
+                return {};
+            }
+        }
+
+        static std::unique_ptr<Runnable> make(const std::string &input_file_path) {
+            return std::make_unique<S>(input_file_path.c_str());
+        }
+    };
+} // namespace Common
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef _REPORT_H_
+#define _REPORT_H_
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Common {
+    struct Phase {
+        std::string name;
+        std::chrono::duration<double> time_elapsed;
+    };
+    using Phases = std::vector<Phase>;
+
+    struct Statistics {
+        size_t iterations;
+        size_t warmup;
+        std::chrono::duration<double> min, median, mean, p99, stddev;
+    };
+
+    // Hardware event count, averaged per solve when benchmarking.
+    struct Counter {
+        std::string name;
+        double value;
+    };
+    using Counters = std::vector<Counter>;
+
+    // Heap usage of a solve (averaged per solve when benchmarking), see alloc_tracker.h.
+    struct Allocations {
+        size_t count;
+        size_t bytes;
+        size_t peak_live_bytes;
+    };
+
+    // Resident set during a solve (or over all timed iterations when benchmarking), see memory_usage.h.
+    struct MemoryUsage {
+        size_t peak_rss_kib;
+        // Peak less what was already resident when the solve started.
+        size_t solve_delta_kib;
+    };
+
+    // Outcome of looking a solve up in the answer cache, see answer_cache.h.
+    struct CacheLookup {
+        bool hit;
+        // Reading & hashing the input, then reading the entry.
+        std::chrono::duration<double> lookup_time;
+    };
+
+    // Where a solve's parsed input came from with --snapshot, see snapshot.h.
+    struct SnapshotUse {
+        // From a snapshot, rather than parsed (& then saved as one).
+        bool loaded;
+        // Of the source text; when loaded, as it took when the snapshot was written.
+        std::chrono::duration<double> parse_time;
+        // Hashing the source & loading the snapshot, when loaded.
+        std::chrono::duration<double> load_time;
+        size_t bytes;
+    };
+
+    // Machine & isolation a benchmark ran under, see benchmark_environment.h.
+    struct BenchmarkEnvironment {
+        std::string cpu_model;
+        // cpufreq scaling governor of the CPU benchmarked on, "unknown" where there's no cpufreq (e.g. most VMs).
+        std::string governor;
+        std::optional<unsigned> pinned_cpu;
+        bool priority_raised = false;
+        // Caches evicted before every timed iteration, rather than left warm from the last.
+        bool cold_cache = false;
+    };
+
+    // Many inputs solved by one day, see solve_throughput() in solver.h.
+    struct Throughput {
+        size_t inputs;
+        size_t failures;
+        size_t threads;
+        std::chrono::duration<double> wall_time;
+        // Per input, from loading it to having its answers.
+        std::chrono::duration<double> latency_p50, latency_p90, latency_p99, latency_max;
+    };
+
+    // Answer with its value already formatted, so that solvers with different answer types can be reported together.
+    struct FormattedAnswer {
+        std::string descriptor;
+        std::string value;
+    };
+
+    // Everything a single solve (or benchmark) produced.
+    struct Report {
+        std::vector<FormattedAnswer> answers;
+        std::chrono::duration<double> time_elapsed;
+        Phases phases;
+        std::optional<Statistics> statistics;
+        // Only present when counters were asked for; empty if none could be collected.
+        std::optional<Counters> counters;
+        // Only present in builds with allocation tracking.
+        std::optional<Allocations> allocations;
+        std::optional<MemoryUsage> memory;
+        // Only present when solving with --cache.
+        std::optional<CacheLookup> cache;
+        // Only present when solving with --snapshot, by days that support it.
+        std::optional<SnapshotUse> snapshot;
+        // Only present for benchmarks.
+        std::optional<BenchmarkEnvironment> environment;
+    };
+
+    inline void print_answers(const std::vector<FormattedAnswer> &answers, std::ostream &out) {
+        for (size_t i = 0; i < answers.size(); ++i) {
+            out << "[Part " << i + 1 << "] " << answers[i].descriptor << ": " << answers[i].value << '\n';
+        }
+    }
+
+    inline void print_phases(const Phases &phases, std::chrono::duration<double> total, std::ostream &out) {
+        if (phases.empty()) {
+            return;
+        }
+
+        const auto name_width =
+            std::accumulate(phases.begin(), phases.end(), size_t{5}, [](size_t acc, const auto &p) {
+                return std::max(acc, p.name.size());
+            });
+
+        const auto flags = out.flags();
+        out << std::left << std::setw(name_width) << "Phase" << "  " << std::right << std::setw(12) << "Time"
+            << "  " << std::setw(6) << "Share" << '\n';
+        for (const auto &phase : phases) {
+            out << std::left << std::setw(name_width) << phase.name << "  " << std::right << std::setw(10)
+                << std::chrono::duration_cast<std::chrono::microseconds>(phase.time_elapsed).count() << "μs"
+                << "  " << std::setw(5) << std::fixed << std::setprecision(1) << 100.0 * phase.time_elapsed / total
+                << "%\n";
+        }
+        out.flags(flags);
+    }
+
+    inline void print_statistics(const Statistics &statistics, std::ostream &out) {
+        const auto microseconds = [](auto duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        };
+
+        const auto flags = out.flags();
+        out << "Iterations: " << statistics.iterations << " (" << statistics.warmup << " warmup)\n"
+            << std::fixed << std::setprecision(1) << "Time taken (min/median/mean/p99/stddev): "
+            << microseconds(statistics.min) << "/" << microseconds(statistics.median) << "/"
+            << microseconds(statistics.mean) << "/" << microseconds(statistics.p99) << "/"
+            << microseconds(statistics.stddev) << "μs\n";
+        out.flags(flags);
+    }
+
+    inline void print_environment(const BenchmarkEnvironment &environment, std::ostream &out) {
+        out << "CPU: " << environment.cpu_model << " (governor: " << environment.governor << ")";
+        if (environment.pinned_cpu) {
+            out << ", pinned to CPU " << *environment.pinned_cpu;
+        }
+        if (environment.priority_raised) {
+            out << ", raised priority";
+        }
+        out << ", " << (environment.cold_cache ? "cold" : "warm") << " cache\n";
+    }
+
+    inline void print_counters(const Counters &counters, std::ostream &out) {
+        if (counters.empty()) {
+            out << "Counters: unavailable\n";
+            return;
+        }
+
+        const auto find = [&](std::string_view name) -> std::optional<double> {
+            const auto it =
+                std::find_if(counters.begin(), counters.end(), [&](const auto &c) { return c.name == name; });
+            return it != counters.end() ? std::optional{it->value} : std::nullopt;
+        };
+
+        const auto flags = out.flags();
+        out << std::fixed << std::setprecision(0);
+        for (const auto &counter : counters) {
+            out << std::left << std::setw(18) << counter.name << std::right << std::setw(16) << counter.value
+                << '\n';
+        }
+
+        const auto cycles = find("cycles");
+        const auto instructions = find("instructions");
+        if (cycles && instructions && *cycles > 0) {
+            out << std::left << std::setw(18) << "IPC" << std::right << std::setw(16) << std::setprecision(2)
+                << *instructions / *cycles << '\n';
+        }
+        out.flags(flags);
+    }
+
+    inline void print_memory(const MemoryUsage &memory, std::ostream &out) {
+        out << "Peak RSS: " << memory.peak_rss_kib << " KiB (+" << memory.solve_delta_kib << " KiB during solve)"
+            << '\n';
+    }
+
+    inline void print_allocations(const Allocations &allocations, std::ostream &out) {
+        out << "Allocations: " << allocations.count << " (" << allocations.bytes << " bytes, peak live "
+            << allocations.peak_live_bytes << " bytes)\n";
+    }
+
+    inline void print_cache_lookup(const CacheLookup &cache, std::ostream &out) {
+        out << "Cache: " << (cache.hit ? "hit" : "miss") << " (lookup "
+            << std::chrono::duration_cast<std::chrono::microseconds>(cache.lookup_time).count() << "μs)\n";
+    }
+
+    inline void print_snapshot_use(const SnapshotUse &snapshot, std::ostream &out) {
+        const auto microseconds = [](auto duration) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        };
+        if (snapshot.loaded) {
+            out << "Snapshot: loaded " << snapshot.bytes << " bytes in " << microseconds(snapshot.load_time)
+                << "μs (parsing took " << microseconds(snapshot.parse_time) << "μs)\n";
+        } else {
+            out << "Snapshot: parsed in " << microseconds(snapshot.parse_time) << "μs & saved " << snapshot.bytes
+                << " bytes\n";
+        }
+    }
+
+    inline void print_throughput(const Throughput &throughput, std::ostream &out) {
+        const auto microseconds = [](auto duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        };
+
+        const auto flags = out.flags();
+        out << "=== Inputs solved: " << throughput.inputs << " (" << throughput.failures << " failed, "
+            << throughput.threads << " threads) ===\n"
+            << std::fixed << std::setprecision(1)
+            << "Throughput: " << static_cast<double>(throughput.inputs) / throughput.wall_time.count()
+            << " inputs/s (wall time " << microseconds(throughput.wall_time) << "μs)\n"
+            << "Latency (p50/p90/p99/max): " << microseconds(throughput.latency_p50) << "/"
+            << microseconds(throughput.latency_p90) << "/" << microseconds(throughput.latency_p99) << "/"
+            << microseconds(throughput.latency_max) << "μs\n";
+        out.flags(flags);
+    }
+
+    inline void print_report(const Report &report, std::ostream &out) {
+        print_answers(report.answers, out);
+
+        if (report.statistics) {
+            print_statistics(*report.statistics, out);
+            if (report.environment) {
+                print_environment(*report.environment, out);
+            }
+        } else {
+            out << "Time taken: " << std::chrono::duration_cast<std::chrono::microseconds>(report.time_elapsed).count()
+                << "μs\n";
+            print_phases(report.phases, report.time_elapsed, out);
+        }
+
+        if (report.cache) {
+            print_cache_lookup(*report.cache, out);
+        }
+        if (report.snapshot) {
+            print_snapshot_use(*report.snapshot, out);
+        }
+        if (report.memory) {
+            print_memory(*report.memory, out);
+        }
+        if (report.allocations) {
+            print_allocations(*report.allocations, out);
+        }
+        if (report.counters) {
+            print_counters(*report.counters, out);
+        }
+    }
+} // namespace Common
+
+#endif
@@ -0,0 +1,404 @@
+#ifndef _RESULTS_H_
+#define _RESULTS_H_
+
+#include "report.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Common {
+    // Reports as JSON lines, one object per day:
+    //  {"year":2021,"day":15,"answers":[{"descriptor":"...","value":"824"},...],"time_us":123.4,
+    //   "statistics":{"iterations":100,"warmup":10,"min_us":...,"median_us":...,"mean_us":...,"p99_us":...,
+    //   "stddev_us":...},"counters":{"cycles":...},"allocations":{...},"memory":{...},"cache":{...},"snapshot":{...},
+    //   "environment":{"cpu_model":"...","governor":"performance","pinned_cpu":2,"priority_raised":true,
+    //   "cache":"cold"}}
+    // Only the members a run produced are written. A saved file of these is what --compare reads back as a baseline.
+    namespace Detail {
+        inline void write_json_string(std::string_view str, std::ostream &out) {
+            out << '"';
+            for (const auto c : str) {
+                switch (c) {
+                case '"':
+                    out << "\\\"";
+                    break;
+                case '\\':
+                    out << "\\\\";
+                    break;
+                case '\n':
+                    out << "\\n";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                            << std::dec << std::setfill(' ');
+                    } else {
+                        out << c;
+                    }
+                }
+            }
+            out << '"';
+        }
+
+        inline double to_microseconds(std::chrono::duration<double> duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        }
+    } // namespace Detail
+
+    // `input` names the input file when a binary solves several.
+    inline void write_json(
+        unsigned year, unsigned day, const Report &report, std::ostream &out, std::string_view input = {}) {
+        const auto flags = out.flags();
+        out << std::fixed << std::setprecision(3) << "{\"year\":" << year << ",\"day\":" << day;
+        if (!input.empty()) {
+            out << ",\"input\":";
+            Detail::write_json_string(input, out);
+        }
+        out << ",\"answers\":[";
+        for (size_t i = 0; i < report.answers.size(); ++i) {
+            out << (i > 0 ? "," : "") << "{\"descriptor\":";
+            Detail::write_json_string(report.answers[i].descriptor, out);
+            out << ",\"value\":";
+            Detail::write_json_string(report.answers[i].value, out);
+            out << "}";
+        }
+        out << "],\"time_us\":" << Detail::to_microseconds(report.time_elapsed);
+
+        if (report.statistics) {
+            const auto &statistics = *report.statistics;
+            out << ",\"statistics\":{\"iterations\":" << statistics.iterations << ",\"warmup\":" << statistics.warmup
+                << ",\"min_us\":" << Detail::to_microseconds(statistics.min)
+                << ",\"median_us\":" << Detail::to_microseconds(statistics.median)
+                << ",\"mean_us\":" << Detail::to_microseconds(statistics.mean)
+                << ",\"p99_us\":" << Detail::to_microseconds(statistics.p99)
+                << ",\"stddev_us\":" << Detail::to_microseconds(statistics.stddev) << "}";
+        }
+
+        if (report.counters) {
+            out << ",\"counters\":{";
+            for (size_t i = 0; i < report.counters->size(); ++i) {
+                out << (i > 0 ? "," : "");
+                Detail::write_json_string((*report.counters)[i].name, out);
+                out << ":" << (*report.counters)[i].value;
+            }
+            out << "}";
+        }
+
+        if (report.allocations) {
+            out << ",\"allocations\":{\"count\":" << report.allocations->count
+                << ",\"bytes\":" << report.allocations->bytes
+                << ",\"peak_live_bytes\":" << report.allocations->peak_live_bytes << "}";
+        }
+
+        if (report.memory) {
+            out << ",\"memory\":{\"peak_rss_kib\":" << report.memory->peak_rss_kib
+                << ",\"solve_delta_kib\":" << report.memory->solve_delta_kib << "}";
+        }
+
+        if (report.cache) {
+            out << ",\"cache\":{\"hit\":" << (report.cache->hit ? "true" : "false")
+                << ",\"lookup_us\":" << Detail::to_microseconds(report.cache->lookup_time) << "}";
+        }
+
+        if (report.snapshot) {
+            out << ",\"snapshot\":{\"loaded\":" << (report.snapshot->loaded ? "true" : "false")
+                << ",\"parse_us\":" << Detail::to_microseconds(report.snapshot->parse_time)
+                << ",\"load_us\":" << Detail::to_microseconds(report.snapshot->load_time)
+                << ",\"bytes\":" << report.snapshot->bytes << "}";
+        }
+
+        if (report.environment) {
+            const auto &environment = *report.environment;
+            out << ",\"environment\":{\"cpu_model\":";
+            Detail::write_json_string(environment.cpu_model, out);
+            out << ",\"governor\":";
+            Detail::write_json_string(environment.governor, out);
+            if (environment.pinned_cpu) {
+                out << ",\"pinned_cpu\":" << *environment.pinned_cpu;
+            }
+            out << ",\"priority_raised\":" << (environment.priority_raised ? "true" : "false")
+                << ",\"cache\":\"" << (environment.cold_cache ? "cold" : "warm") << "\"}";
+        }
+
+        out << "}\n";
+        out.flags(flags);
+    }
+
+    inline void write_json_error(
+        unsigned year, unsigned day, std::string_view error, std::ostream &out, std::string_view input = {}) {
+        out << "{\"year\":" << year << ",\"day\":" << day;
+        if (!input.empty()) {
+            out << ",\"input\":";
+            Detail::write_json_string(input, out);
+        }
+        out << ",\"error\":";
+        Detail::write_json_string(error, out);
+        out << "}\n";
+    }
+
+    namespace Detail {
+        // Just enough JSON to read results back: collects every numeric member of one object, keyed by its path
+        // (e.g. "statistics.mean_us"). Strings, booleans & nulls are skipped.
+        class NumberCollector {
+          public:
+            explicit NumberCollector(std::string_view text) : text{text} {}
+
+            std::map<std::string, double> collect() {
+                auto numbers = std::map<std::string, double>{};
+                value("", numbers);
+                skip_whitespace();
+                if (position != text.size()) {
+                    throw std::runtime_error{"malformed_json"};
+                }
+                return numbers;
+            }
+
+          private:
+            std::string_view text;
+            size_t position = 0;
+
+            void skip_whitespace() {
+                position = std::min(text.find_first_not_of(" \t\r\n", position), text.size());
+            }
+
+            void expect(char c) {
+                skip_whitespace();
+                if (position >= text.size() || text[position] != c) {
+                    throw std::runtime_error{"malformed_json"};
+                }
+                ++position;
+            }
+
+            bool consume(char c) {
+                skip_whitespace();
+                if (position < text.size() && text[position] == c) {
+                    ++position;
+                    return true;
+                }
+                return false;
+            }
+
+            std::string string() {
+                expect('"');
+                auto str = std::string{};
+                while (position < text.size() && text[position] != '"') {
+                    if (text[position] == '\\') {
+                        ++position;
+                        if (position < text.size() && text[position] == 'u') {
+                            // Not needed for anything that's read back, so keep a placeholder.
+                            position += 4;
+                            str += '?';
+                        } else if (position < text.size()) {
+                            str += text[position] == 'n' ? '\n' : text[position];
+                        }
+                    } else {
+                        str += text[position];
+                    }
+                    ++position;
+                }
+                expect('"');
+                return str;
+            }
+
+            void value(const std::string &path, std::map<std::string, double> &numbers) {
+                skip_whitespace();
+                if (position >= text.size()) {
+                    throw std::runtime_error{"malformed_json"};
+                }
+
+                const auto member_path = [&](const std::string &name) {
+                    return path.empty() ? name : path + "." + name;
+                };
+
+                switch (text[position]) {
+                case '{':
+                    ++position;
+                    if (consume('}')) {
+                        return;
+                    }
+                    do {
+                        const auto name = string();
+                        expect(':');
+                        value(member_path(name), numbers);
+                    } while (consume(','));
+                    expect('}');
+                    return;
+                case '[':
+                    ++position;
+                    if (consume(']')) {
+                        return;
+                    }
+                    for (size_t i = 0;; ++i) {
+                        value(member_path(std::to_string(i)), numbers);
+                        if (!consume(',')) {
+                            break;
+                        }
+                    }
+                    expect(']');
+                    return;
+                case '"':
+                    string();
+                    return;
+                default:
+                    const auto end = text.find_first_of(",}] \t\r\n", position);
+                    const auto literal = text.substr(position, end - position);
+                    position += literal.size();
+                    if (literal == "true" || literal == "false" || literal == "null") {
+                        return;
+                    }
+
+                    auto number = 0.0;
+                    const auto [ptr, err] = std::from_chars(literal.data(), literal.data() + literal.size(), number);
+                    if (err != std::errc{} || ptr != literal.data() + literal.size()) {
+                        throw std::runtime_error{"malformed_json"};
+                    }
+                    numbers[path] = number;
+                }
+            }
+        };
+
+        // One-sided 95% critical value of Student's t distribution.
+        inline double t_critical_95(double degrees_of_freedom) {
+            // For 1 to 30 degrees of freedom.
+            static constexpr auto TABLE = std::array{
+                6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+                1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+                1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697,
+            };
+            const auto df = static_cast<size_t>(std::max(1.0, std::floor(degrees_of_freedom)));
+            if (df <= TABLE.size()) {
+                return TABLE[df - 1];
+            }
+            return df <= 40 ? 1.684 : df <= 60 ? 1.671 : df <= 120 ? 1.658 : 1.645;
+        }
+    } // namespace Detail
+
+    // Benchmark timings of one day from a results file.
+    struct BaselineEntry {
+        unsigned year;
+        unsigned day;
+        size_t iterations;
+        double mean_us;
+        double stddev_us;
+    };
+
+    // Reads the benchmarked days out of a file of JSON lines written by write_json; other lines are ignored.
+    inline std::vector<BaselineEntry> load_baseline(const std::string &path) {
+        auto file = std::ifstream{path};
+        if (!file.is_open()) {
+            throw std::runtime_error{"baseline_open_failed"};
+        }
+
+        auto entries = std::vector<BaselineEntry>{};
+        for (auto line = std::string{}; std::getline(file, line);) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            const auto numbers = Detail::NumberCollector{line}.collect();
+            const auto field = [&](const char *const name) { return numbers.find(name); };
+            if (field("year") == numbers.end() || field("day") == numbers.end() ||
+                field("statistics.iterations") == numbers.end() || field("statistics.mean_us") == numbers.end() ||
+                field("statistics.stddev_us") == numbers.end()) {
+                continue;
+            }
+
+            entries.emplace_back(BaselineEntry{
+                static_cast<unsigned>(field("year")->second),
+                static_cast<unsigned>(field("day")->second),
+                static_cast<size_t>(field("statistics.iterations")->second),
+                field("statistics.mean_us")->second,
+                field("statistics.stddev_us")->second,
+            });
+        }
+        return entries;
+    }
+
+    struct Comparison {
+        double baseline_mean_us;
+        double mean_us;
+        // Relative change of the mean, e.g. 0.05 for 5% slower.
+        double change;
+        // Welch's t statistic, positive when slower than the baseline.
+        double t;
+        bool regression;
+        bool improvement;
+    };
+
+    // Welch's t-test on the means, since the two runs needn't have the same variance or iteration count. A change
+    // only counts if it's both statistically significant (one-sided, 95%) & bigger than `threshold`.
+    inline Comparison compare(const BaselineEntry &baseline, const Statistics &current, double threshold) {
+        const auto mean_us = Detail::to_microseconds(current.mean);
+        const auto stddev_us = Detail::to_microseconds(current.stddev);
+        const auto n = static_cast<double>(current.iterations);
+        const auto baseline_n = static_cast<double>(baseline.iterations);
+
+        const auto variance = stddev_us * stddev_us / n;
+        const auto baseline_variance = baseline.stddev_us * baseline.stddev_us / baseline_n;
+        const auto difference = mean_us - baseline.mean_us;
+        const auto standard_error = std::sqrt(variance + baseline_variance);
+
+        const auto t = standard_error > 0 ? difference / standard_error
+            : difference == 0             ? 0.0
+                                          : std::copysign(INFINITY, difference);
+        const auto degrees_of_freedom = n > 1 && baseline_n > 1 && standard_error > 0
+            ? std::pow(variance + baseline_variance, 2) /
+                (variance * variance / (n - 1) + baseline_variance * baseline_variance / (baseline_n - 1))
+            : 1.0;
+
+        const auto change = baseline.mean_us > 0 ? difference / baseline.mean_us : 0.0;
+        const auto significant = std::abs(t) > Detail::t_critical_95(degrees_of_freedom);
+        return Comparison{baseline.mean_us,
+                          mean_us,
+                          change,
+                          t,
+                          significant && change > threshold,
+                          significant && change < -threshold};
+    }
+
+    inline void print_comparison(const Comparison &comparison, std::ostream &out) {
+        const auto flags = out.flags();
+        out << std::fixed << std::setprecision(1) << "Baseline mean: " << comparison.baseline_mean_us << "μs -> "
+            << comparison.mean_us << "μs (" << std::showpos << 100.0 * comparison.change << "%" << std::noshowpos
+            << ", t=" << std::setprecision(2) << comparison.t << "): "
+            << (comparison.regression        ? "REGRESSION"
+                    : comparison.improvement ? "faster"
+                                             : "no significant change")
+            << '\n';
+        out.flags(flags);
+    }
+
+    // Compares a benchmarked report with the matching baseline entry, if there is one, printing the outcome.
+    // Returns false on a regression.
+    inline bool check_against_baseline(const std::vector<BaselineEntry> &baseline,
+                                       unsigned year,
+                                       unsigned day,
+                                       const Report &report,
+                                       double threshold,
+                                       std::ostream &out) {
+        const auto entry = std::find_if(
+            baseline.begin(), baseline.end(), [&](const auto &e) { return e.year == year && e.day == day; });
+        if (entry == baseline.end() || !report.statistics) {
+            out << "Baseline: none for " << year << "/" << day << '\n';
+            return true;
+        }
+
+        const auto comparison = compare(*entry, *report.statistics, threshold);
+        print_comparison(comparison, out);
+        return !comparison.regression;
+    }
+} // namespace Common
+
+#endif
@@ -0,0 +1,227 @@
+#include "../scaling.h"
+#include "../solver.h"
+#include "../trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Runner {
+    using Entry = Common::Registry::Entry;
+    using Clock = std::chrono::steady_clock;
+
+    struct Outcome {
+        std::optional<Common::Report> report;
+        std::string error;
+        // Offset from the start of the whole run at which this day finished.
+        std::chrono::duration<double> finished_at;
+    };
+
+    // "2021" selects every day of 2021 & "2021/15" selects just that day. No selectors selects everything.
+    bool is_selected(const Entry &entry, const std::vector<std::string> &selectors) {
+        if (selectors.empty()) {
+            return true;
+        }
+
+        const auto year = std::to_string(entry.year);
+        const auto year_and_day = year + "/" + std::to_string(entry.day);
+        return std::any_of(selectors.begin(), selectors.end(), [&](const auto &selector) {
+            return selector == year || selector == year_and_day;
+        });
+    }
+
+    // This binary is built one level below the repository root. Found through /proc/self/exe where there is one, as
+    // argv[0] may be a symlink or just a name looked up on PATH.
+    std::filesystem::path repository_root(const char *const program) {
+        auto ec = std::error_code{};
+        auto executable = std::filesystem::read_symlink("/proc/self/exe", ec);
+        if (ec) {
+            executable = std::filesystem::weakly_canonical(program, ec);
+            if (ec) {
+                executable = program;
+            }
+        }
+        return executable.parent_path() / "..";
+    }
+
+    // Inputs live at <repository root>/<year>/<day>/input.txt.
+    std::filesystem::path input_file_path(const std::filesystem::path &root, const Entry &entry) {
+        return root / std::to_string(entry.year) / std::to_string(entry.day) / "input.txt";
+    }
+
+    // Runs every entry on `jobs` threads. Each thread claims the next unclaimed entry, slowest expected first, so the
+    // long days don't end up starting last & stretching out the total wall time.
+    std::vector<Outcome> run_all(const std::vector<Entry> &entries,
+                                 const Common::Options &options,
+                                 const std::filesystem::path &root,
+                                 size_t jobs) {
+        auto order = std::vector<size_t>(entries.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        if (jobs > 1) {
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return entries[a].expected_time > entries[b].expected_time;
+            });
+        }
+
+        auto outcomes = std::vector<Outcome>(entries.size());
+        auto next = std::atomic<size_t>{0};
+        const auto start = Clock::now();
+
+        const auto worker = [&]() {
+            for (auto i = next++; i < order.size(); i = next++) {
+                const auto &entry = entries[order[i]];
+                auto &outcome = outcomes[order[i]];
+                const auto label = std::to_string(entry.year) + "/" + std::to_string(entry.day);
+                const auto span = Common::TraceSpan{label.c_str()};
+                try {
+                    const auto solver = entry.make(input_file_path(root, entry));
+                    outcome.report = Common::run(*solver, options);
+                } catch (const std::exception &e) {
+                    outcome.error = e.what();
+                }
+                outcome.finished_at = Clock::now() - start;
+            }
+        };
+
+        auto threads = std::vector<std::thread>{};
+        for (size_t i = 1; i < std::min(jobs, entries.size()); ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        return outcomes;
+    }
+
+    // Always one day at a time, so that days don't skew each other's timings. Returns the number of failures.
+    size_t run_scaling(const std::vector<Entry> &entries, const Common::Options &options) {
+        auto failures = size_t{0};
+        for (const auto &entry : entries) {
+            if (!entry.generate) {
+                continue;
+            }
+
+            std::cout << "=== " << entry.year << "/" << entry.day << " ===\n";
+            try {
+                Common::print_scaling(Common::measure_scaling(entry, options), std::cout);
+            } catch (const std::exception &e) {
+                std::cout << "Failed: " << e.what() << '\n';
+                ++failures;
+            }
+        }
+        return failures;
+    }
+
+    void print_usage(const char *const program) {
+        Common::print_usage(program, "[YEAR | YEAR/DAY]...");
+        std::cerr << "  [YEAR | YEAR/DAY]... Only run the selected days (default: all)\n";
+    }
+} // namespace Runner
+
+int main(int argc, char **argv) {
+    const auto options = Common::parse_options(argc, argv);
+    if (!options || options->input_list || options->throughput || options->stream_interval_ms) {
+        Runner::print_usage(argv[0]);
+        return 1;
+    }
+
+    auto entries = Common::Registry::instance().all();
+    std::erase_if(entries, [&](const auto &entry) { return !Runner::is_selected(entry, options->positional); });
+
+    if (options->scaling.enabled) {
+        return Runner::run_scaling(entries, *options) == 0 ? 0 : 1;
+    }
+
+    const auto jobs = options->jobs == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : options->jobs;
+
+    auto baseline = std::vector<Common::BaselineEntry>{};
+    try {
+        if (options->compare_baseline) {
+            baseline = Common::load_baseline(*options->compare_baseline);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    Common::start_tracing(*options);
+    const auto wall_start = Runner::Clock::now();
+    const auto outcomes = Runner::run_all(entries, *options, Runner::repository_root(argv[0]), jobs);
+    const auto wall = Runner::Clock::now() - wall_start;
+    try {
+        Common::finish_tracing(*options);
+    } catch (const std::exception &e) {
+        std::cerr << "Failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    const auto microseconds = [](auto duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+
+    auto total = std::chrono::duration<double>{};
+    auto failures = size_t{0};
+    auto regressions = size_t{0};
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto &entry = entries[i];
+        const auto &outcome = outcomes[i];
+
+        if (options->json) {
+            if (outcome.report) {
+                Common::write_json(entry.year, entry.day, *outcome.report, std::cout);
+            } else {
+                Common::write_json_error(entry.year, entry.day, outcome.error, std::cout);
+            }
+        } else {
+            std::cout << "=== " << entry.year << "/" << entry.day << " ===\n";
+        }
+
+        if (!outcome.report) {
+            if (!options->json) {
+                std::cout << "Failed: " << outcome.error << '\n';
+            }
+            ++failures;
+            continue;
+        }
+
+        if (!options->json) {
+            Common::print_report(*outcome.report, std::cout);
+            if (jobs > 1) {
+                std::cout << "Finished at: " << microseconds(outcome.finished_at) << "μs\n";
+            }
+        }
+
+        if (options->compare_baseline) {
+            const auto threshold = static_cast<double>(options->regression_threshold_percent) / 100.0;
+            auto &out = options->json ? std::cerr : std::cout;
+            if (!Common::check_against_baseline(baseline, entry.year, entry.day, *outcome.report, threshold, out)) {
+                ++regressions;
+            }
+        }
+        total += outcome.report->time_elapsed;
+    }
+
+    // The summary isn't a result, so leave it out of JSON output.
+    if (options->json) {
+        return failures == 0 && regressions == 0 ? 0 : 1;
+    }
+
+    if (options->compare_baseline) {
+        std::cout << "=== Regressions: " << regressions << " ===\n";
+    }
+    std::cout << "=== Days run: " << entries.size() << " (" << failures << " failed, " << jobs << " threads) ==="
+              << '\n'
+              << "Total time taken: " << microseconds(total) << "μs\n"
+              << "Wall time: " << microseconds(wall) << "μs\n";
+
+    return failures == 0 && regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#ifndef _SCALING_H_
+#define _SCALING_H_
+
+#include "options.h"
+#include "registry.h"
+#include "report.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Common {
+    struct ScalingPoint {
+        size_t scale;
+        size_t input_bytes;
+        // Median over the timed solves.
+        std::chrono::duration<double> time_elapsed;
+    };
+
+    struct ScalingResult {
+        std::vector<ScalingPoint> points;
+        // Scales not run because they were predicted to take longer than the budget.
+        std::vector<size_t> skipped;
+        // k in time ~ input_bytes^k, from a least squares fit on log-log axes. Needs at least two points.
+        std::optional<double> exponent;
+    };
+
+    namespace Detail {
+        inline std::optional<double> fit_exponent(const std::vector<ScalingPoint> &points) {
+            if (points.size() < 2) {
+                return std::nullopt;
+            }
+
+            auto sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+            for (const auto &point : points) {
+                const auto x = std::log(static_cast<double>(point.input_bytes));
+                const auto y = std::log(point.time_elapsed.count());
+                sum_x += x;
+                sum_y += y;
+                sum_xx += x * x;
+                sum_xy += x * y;
+            }
+
+            const auto n = static_cast<double>(points.size());
+            const auto denominator = n * sum_xx - sum_x * sum_x;
+            if (denominator == 0) {
+                return std::nullopt;
+            }
+            return (n * sum_xy - sum_x * sum_y) / denominator;
+        }
+
+        // Generated input written out for the solver to read, removed again once solved.
+        class TemporaryInput {
+          public:
+            TemporaryInput(const Registry::Entry &entry, size_t scale, const std::string &contents)
+                : path{std::filesystem::temp_directory_path() /
+                       ("aoc-" + std::to_string(entry.year) + "-" + std::to_string(entry.day) + "-" +
+                        std::to_string(scale) + "x-" + std::to_string(::getpid()) + ".txt")} {
+                auto file = std::ofstream{path, std::ios::binary};
+                if (!(file << contents)) {
+                    throw std::runtime_error{"temporary_input_write_failed"};
+                }
+            }
+            TemporaryInput(const TemporaryInput &) = delete;
+            TemporaryInput &operator=(const TemporaryInput &) = delete;
+
+            ~TemporaryInput() {
+                auto ec = std::error_code{};
+                std::filesystem::remove(path, ec);
+            }
+
+            const std::filesystem::path path;
+        };
+    } // namespace Detail
+
+    // Solves generated inputs at 1x, 10x, 100x... up to --max-scale & fits how the solve time grows with input size.
+    // Stops early rather than run a scale the growth so far predicts would take over `budget`.
+    inline ScalingResult measure_scaling(const Registry::Entry &entry,
+                                         const Options &options,
+                                         std::chrono::duration<double> budget = std::chrono::seconds{10}) {
+        if (!entry.generate) {
+            throw std::runtime_error{"no_input_generator"};
+        }
+
+        const auto iterations = options.benchmark.iterations > 0 ? options.benchmark.iterations : size_t{3};
+        auto result = ScalingResult{};
+
+        for (size_t scale = 1; scale <= options.scaling.max_scale; scale *= 10) {
+            if (!result.points.empty()) {
+                const auto &last = result.points.back();
+                const auto exponent = result.exponent.value_or(1.0);
+                const auto predicted = last.time_elapsed * std::pow(10.0, exponent) * static_cast<double>(iterations);
+                if (predicted > budget) {
+                    for (; scale <= options.scaling.max_scale; scale *= 10) {
+                        result.skipped.emplace_back(scale);
+                    }
+                    break;
+                }
+            }
+
+            const auto contents = entry.generate(scale, options.scaling.seed);
+            const auto input = Detail::TemporaryInput{entry, scale, contents};
+
+            const auto solver = entry.make(input.path);
+            solver->configure(options);
+            const auto report = solver->run_benchmark(iterations, 1);
+
+            result.points.emplace_back(ScalingPoint{scale, contents.size(), report.time_elapsed});
+            result.exponent = Detail::fit_exponent(result.points);
+        }
+
+        return result;
+    }
+
+    inline void print_scaling(const ScalingResult &result, std::ostream &out) {
+        const auto flags = out.flags();
+        out << std::right << std::setw(7) << "Scale" << std::setw(14) << "Input bytes" << std::setw(16) << "Time"
+            << std::endl;
+        for (const auto &point : result.points) {
+            out << std::setw(6) << point.scale << "x" << std::setw(14) << point.input_bytes << std::setw(14)
+                << std::chrono::duration_cast<std::chrono::microseconds>(point.time_elapsed).count() << "μs"
+                << std::endl;
+        }
+        for (const auto scale : result.skipped) {
+            out << std::setw(6) << scale << "x" << std::setw(30) << "skipped (too slow)" << std::endl;
+        }
+
+        if (result.exponent) {
+            out << "Growth: time ~ n^" << std::fixed << std::setprecision(2) << *result.exponent << std::endl;
+        } else {
+            out << "Growth: not enough points to fit" << std::endl;
+        }
+        out.flags(flags);
+    }
+} // namespace Common
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include "answer_cache.h"
+#include "mapped_file.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Common {
+    namespace Detail {
+        template <typename T> T to_little_endian(T value) {
+            if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1) {
+                return value;
+            } else {
+                auto swapped = std::make_unsigned_t<T>{0};
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    swapped = (swapped << 8) | ((static_cast<std::make_unsigned_t<T>>(value) >> (8 * i)) & 0xFF);
+                }
+                return static_cast<T>(swapped);
+            }
+        }
+
+        // 64-bit hash of `bytes` a word at a time (multiply & rotate, then a final mix), several times quicker than
+        // content_hash()'s FNV-1a, which matters as every load has to hash the whole source first.
+        inline uint64_t source_hash(std::string_view bytes, uint64_t hash) {
+            constexpr auto MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+            const auto mix = [&](uint64_t word) {
+                hash = std::rotl((hash ^ word) * MULTIPLIER, 31);
+            };
+
+            size_t i = 0;
+            for (; i + 8 <= bytes.size(); i += 8) {
+                auto word = uint64_t{0};
+                std::memcpy(&word, bytes.data() + i, sizeof(word));
+                mix(to_little_endian(word));
+            }
+            auto tail = uint64_t{0};
+            for (size_t shift = 0; i < bytes.size(); ++i, shift += 8) {
+                tail |= uint64_t{static_cast<unsigned char>(bytes[i])} << shift;
+            }
+            mix(tail ^ bytes.size());
+
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+    } // namespace Detail
+
+    // Builds the payload of a snapshot: integers (& enums) little-endian, strings & arrays prefixed with a u64 count.
+    class SnapshotWriter {
+      public:
+        template <typename T> void put(T value) {
+            if constexpr (std::is_enum_v<T>) {
+                put(static_cast<std::underlying_type_t<T>>(value));
+            } else {
+                static_assert(std::is_integral_v<T>);
+                value = Detail::to_little_endian(value);
+                bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+            }
+        }
+
+        void put(std::string_view str) {
+            put(uint64_t{str.size()});
+            bytes.append(str);
+        }
+
+        template <typename T> void put_array(const T *const values, size_t count) {
+            put(uint64_t{count});
+            if constexpr (std::endian::native == std::endian::little && std::is_integral_v<T>) {
+                bytes.append(reinterpret_cast<const char *>(values), count * sizeof(T));
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    put(values[i]);
+                }
+            }
+        }
+
+        const std::string &payload() const { return bytes; }
+
+      private:
+        std::string bytes;
+    };
+
+    // Reads back what a SnapshotWriter put, in the same order, straight out of the (mapped) snapshot. Throws
+    // malformed_snapshot rather than reading past the end.
+    class SnapshotReader {
+      public:
+        explicit SnapshotReader(std::string_view payload) : remaining{payload} {}
+
+        template <typename T> T get() {
+            if constexpr (std::is_enum_v<T>) {
+                return static_cast<T>(get<std::underlying_type_t<T>>());
+            } else {
+                static_assert(std::is_integral_v<T>);
+                auto value = T{};
+                std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+                return Detail::to_little_endian(value);
+            }
+        }
+
+        // Only valid as long as the snapshot stays mapped.
+        std::string_view get_string() { return take(get_count(1)); }
+
+        // Into `count` values at `out`, which must match the array's length.
+        template <typename T> void get_array(T *const out, size_t count) {
+            if (get_count(sizeof(T)) != count) {
+                throw std::runtime_error{"malformed_snapshot"};
+            }
+            if constexpr (std::endian::native == std::endian::little && std::is_integral_v<T>) {
+                std::memcpy(out, take(count * sizeof(T)).data(), count * sizeof(T));
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = get<T>();
+                }
+            }
+        }
+
+        template <typename T> std::vector<T> get_array() {
+            auto values = std::vector<T>(peek_count(sizeof(T)));
+            get_array(values.data(), values.size());
+            return values;
+        }
+
+        // A u64 count, of things at least `item_size` bytes each that must all still be there.
+        size_t get_count(size_t item_size) {
+            const auto count = peek_count(item_size);
+            take(sizeof(uint64_t));
+            return count;
+        }
+
+        bool done() const { return remaining.empty(); }
+
+      private:
+        std::string_view remaining;
+
+        size_t peek_count(size_t item_size) const {
+            auto count = uint64_t{0};
+            if (remaining.size() < sizeof(count)) {
+                throw std::runtime_error{"malformed_snapshot"};
+            }
+            std::memcpy(&count, remaining.data(), sizeof(count));
+            count = Detail::to_little_endian(count);
+            if (item_size > 0 && count > (remaining.size() - sizeof(count)) / item_size) {
+                throw std::runtime_error{"malformed_snapshot"};
+            }
+            return static_cast<size_t>(count);
+        }
+
+        std::string_view take(size_t size) {
+            if (remaining.size() < size) {
+                throw std::runtime_error{"malformed_snapshot"};
+            }
+            const auto taken = remaining.substr(0, size);
+            remaining.remove_prefix(size);
+            return taken;
+        }
+    };
+
+    // On-disk store of parsed inputs, so that solving the same input again can skip parsing. Entries are keyed like the
+    // answer cache's (a hash of the solver identity, its snapshot version & the source text) & laid out as, all
+    // integers little-endian:
+    //   "aocsnap" & a NUL, u32 FORMAT_VERSION, u32 solver snapshot version, u64 key hash, u64 source size,
+    //   u64 nanoseconds the parse took, identity (u64 length & bytes), u64 payload checksum, u64 payload size, payload
+    // Loading checks all but the parse time against the solver & input at hand, & the checksum against the payload.
+    class SnapshotStore {
+      public:
+        static constexpr uint32_t FORMAT_VERSION = 2;
+
+        SnapshotStore(std::filesystem::path directory, std::string identity, unsigned version)
+            : directory{std::move(directory)}, identity{std::move(identity)}, version{version} {}
+
+        using Key = AnswerCache::Key;
+
+        Key key(std::string_view source) const {
+            const auto tag = "snapshot\n" + identity + '\n' + std::to_string(version) + '\n';
+            return Key{Detail::source_hash(source, content_hash(tag)), source.size()};
+        }
+
+        // A snapshot that matches the key, mapped into memory.
+        struct Entry {
+            MappedFile file;
+            std::chrono::nanoseconds parse_time;
+            size_t payload_offset;
+
+            std::string_view payload() const { return file.view().substr(payload_offset); }
+        };
+
+        // Nothing for a missing, mismatched or corrupt entry, which just means parsing again.
+        std::optional<Entry> load(const Key &key) const {
+            const auto path = entry_path(key);
+            auto ec = std::error_code{};
+            if (!std::filesystem::is_regular_file(path, ec)) {
+                return std::nullopt;
+            }
+
+            try {
+                auto file = MappedFile{path.string()};
+                const auto contents = file.view();
+                auto reader = SnapshotReader{contents};
+                if (reader.get<uint64_t>() != magic_value() || reader.get<uint32_t>() != FORMAT_VERSION ||
+                    reader.get<uint32_t>() != version || reader.get<uint64_t>() != key.hash ||
+                    reader.get<uint64_t>() != key.input_size) {
+                    return std::nullopt;
+                }
+                const auto parse_time = std::chrono::nanoseconds{reader.get<uint64_t>()};
+                if (reader.get_string() != identity) {
+                    return std::nullopt;
+                }
+                const auto checksum = reader.get<uint64_t>();
+                const auto payload = reader.get_string();
+                if (!reader.done() || payload_checksum(payload) != checksum) {
+                    return std::nullopt;
+                }
+                const auto payload_offset = static_cast<size_t>(payload.data() - contents.data());
+                return Entry{std::move(file), parse_time, payload_offset};
+            } catch (const std::runtime_error &) {
+                return std::nullopt;
+            }
+        }
+
+        // Written to a temporary file & renamed into place, like the answer cache's entries. Failing to store only
+        // costs a future parse, so errors are ignored.
+        void store(const Key &key, std::chrono::nanoseconds parse_time, std::string_view payload) const {
+            auto ec = std::error_code{};
+            std::filesystem::create_directories(directory, ec);
+
+            auto header = SnapshotWriter{};
+            header.put(magic_value());
+            header.put(FORMAT_VERSION);
+            header.put(uint32_t{version});
+            header.put(uint64_t{key.hash});
+            header.put(uint64_t{key.input_size});
+            header.put(static_cast<uint64_t>(parse_time.count()));
+            header.put(std::string_view{identity});
+            header.put(payload_checksum(payload));
+            header.put(uint64_t{payload.size()});
+
+            static auto counter = std::atomic<unsigned>{0};
+            const auto final_path = entry_path(key);
+            auto temporary_path = final_path;
+            temporary_path += ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter++);
+
+            {
+                auto file = std::ofstream{temporary_path, std::ios::binary | std::ios::trunc};
+                file.write(header.payload().data(), static_cast<std::streamsize>(header.payload().size()));
+                file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+                if (!file.flush()) {
+                    std::filesystem::remove(temporary_path, ec);
+                    return;
+                }
+            }
+
+            std::filesystem::rename(temporary_path, final_path, ec);
+            if (ec) {
+                std::filesystem::remove(temporary_path, ec);
+            }
+        }
+
+      private:
+        static constexpr char MAGIC[8] = {'a', 'o', 'c', 's', 'n', 'a', 'p', '\0'};
+
+        const std::filesystem::path directory;
+        const std::string identity;
+        const unsigned version;
+
+        static uint64_t magic_value() {
+            auto value = uint64_t{0};
+            for (size_t i = sizeof(MAGIC); i-- > 0;) {
+                value = (value << 8) | static_cast<unsigned char>(MAGIC[i]);
+            }
+            return value;
+        }
+
+        static uint64_t payload_checksum(std::string_view payload) {
+            return Detail::source_hash(payload, content_hash("snapshot payload"));
+        }
+
+        std::filesystem::path entry_path(const Key &key) const {
+            auto name = std::ostringstream{};
+            name << std::hex << std::setw(16) << std::setfill('0') << key.hash << ".snapshot";
+            return directory / name.str();
+        }
+    };
+} // namespace Common
+
+#endif
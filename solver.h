@@ -1,15 +1,50 @@
 #ifndef _SOLVER_H_
 #define _SOLVER_H_
 
+#include "answer_cache.h"
+#include "arena.h"
+#include "benchmark_environment.h"
+#include "incremental.h"
+#include "mapped_file.h"
+#include "memory_usage.h"
+#include "options.h"
+#include "perf_counters.h"
+#include "registry.h"
+#include "report.h"
+#include "results.h"
+#include "scaling.h"
+#include "snapshot.h"
+#include "trace.h"
+#include "utils.h"
+#include "work_stealing.h"
+
+#ifdef AOC_ALLOC_TRACKING
+#include "alloc_tracker.h"
+#endif
+
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
+#include <typeinfo>
 #include <vector>
 
 namespace Common {
-    template <typename T> class Solver {
+    template <typename T> class Solver : public Runnable {
       public:
         using Answer = struct {
             std::string descriptor;
@@ -18,42 +53,831 @@ namespace Common {
         using Answers = std::vector<Answer>;
         using Error = std::runtime_error;
 
+        // How a solver wants its input handed to it.
+        //  stream - solve(std::istream &) gets a stream of the input file.
+        //  mapped - solve_mapped(std::string_view) gets the whole file mapped read-only into memory.
+        enum class InputMode { stream, mapped };
+
+        using Phase = ::Common::Phase;
+        using Phases = ::Common::Phases;
+        using Statistics = ::Common::Statistics;
+        using Counters = ::Common::Counters;
+        using Allocations = ::Common::Allocations;
+        using MemoryUsage = ::Common::MemoryUsage;
+        using CacheLookup = ::Common::CacheLookup;
+        using SnapshotUse = ::Common::SnapshotUse;
+
         using AnswersWithDuration = struct {
             Answers answers;
             std::chrono::duration<double> time_elapsed;
+            Phases phases;
+            std::optional<Counters> counters;
+            std::optional<Allocations> allocations;
+            std::optional<MemoryUsage> memory;
+            std::optional<CacheLookup> cache;
+            std::optional<SnapshotUse> snapshot;
+        };
+
+        using BenchmarkResult = struct {
+            Answers answers;
+            Statistics statistics;
+            // Per timed iteration.
+            std::optional<Counters> counters;
+            std::optional<Allocations> allocations;
+            std::optional<MemoryUsage> memory;
         };
 
         Solver(const char *const input_file_path) : input_file_path{input_file_path} {}
 
+        // With --cache, answers stored for the same input (& solver version) are returned without solving, & new ones
+        // are stored for next time. The time taken then includes hashing the input.
         AnswersWithDuration get_answers() {
+            auto memory_meter = MemoryMeter{measure_memory};
+            memory_meter.start();
+            start_allocations();
             auto start = std::chrono::steady_clock::now();
-            auto input = std::ifstream{input_file_path, std::ios::in};
-            if (!input.is_open()) {
-                throw Error{"file_open_failed"};
+
+#ifdef AOC_EMBED_INPUT
+            if (input_file_path == AOC_EMBED_INPUT) {
+                if (auto answers = embedded_answers()) {
+                    const auto time_elapsed = std::chrono::steady_clock::now() - start;
+                    return AnswersWithDuration{std::move(*answers),
+                                               time_elapsed,
+                                               {},
+                                               std::nullopt,
+                                               stop_allocations(1),
+                                               memory_meter.stop(),
+                                               std::nullopt,
+                                               std::nullopt};
+                }
+            }
+#endif
+
+            auto input = load_input();
+
+            auto cache_key = std::optional<AnswerCache::Key>{};
+            auto cache_lookup = std::optional<CacheLookup>{};
+            if (answer_cache) {
+                const auto lookup_start = std::chrono::steady_clock::now();
+                cache_key = cache_key_of(input);
+                auto cached = answer_cache->load<Answers>(*cache_key);
+                cache_lookup = CacheLookup{cached.has_value(), std::chrono::steady_clock::now() - lookup_start};
+                if (cached) {
+                    const auto time_elapsed = std::chrono::steady_clock::now() - start;
+                    return AnswersWithDuration{std::move(*cached),
+                                               time_elapsed,
+                                               {},
+                                               std::nullopt,
+                                               stop_allocations(1),
+                                               memory_meter.stop(),
+                                               cache_lookup,
+                                               std::nullopt};
+                }
             }
 
-            return AnswersWithDuration{solve(input), std::chrono::steady_clock::now() - start};
+            start_counters();
+            auto answers = solve_loaded(input);
+            auto counters = stop_counters(1);
+            const auto time_elapsed = std::chrono::steady_clock::now() - start;
+            auto allocations = stop_allocations(1);
+
+            if (cache_key) {
+                answer_cache->store(*cache_key, answers);
+            }
+            return AnswersWithDuration{std::move(answers),
+                                       time_elapsed,
+                                       std::move(recorded_phases),
+                                       std::move(counters),
+                                       std::move(allocations),
+                                       memory_meter.stop(),
+                                       cache_lookup,
+                                       snapshot_use};
         }
 
-        void print_answers() {
-            const auto result = get_answers();
-            const auto answers = result.answers;
-            const auto size = answers.size();
-            for (size_t i = 0; i < size; ++i) {
-                const auto &answer = answers[i];
-                std::cout << "[Part " << i + 1 << "] " << answer.descriptor << ": " << answer.value << std::endl;
+        // Loads the input once, then times only the solve over `iterations` runs (after `warmup` untimed runs).
+        // Every run must produce the same answers. Never answered from the cache, since that would time nothing. With
+        // --cold-cache the caches are evicted before each timed run, outside of the timings & counters.
+        BenchmarkResult benchmark(size_t iterations, size_t warmup = 0) {
+            if (iterations == 0) {
+                throw Error{"no_iterations"};
+            }
+
+            auto input = load_input();
+
+            // From the first solve on, so that memory it leaves resident for later iterations still counts.
+            auto memory_meter = MemoryMeter{measure_memory};
+            memory_meter.start();
+
+            const auto answers = solve_loaded(input);
+            for (size_t i = 0; i < warmup; ++i) {
+                check_answers_match(answers, solve_loaded(input));
+            }
+
+            auto durations = std::vector<std::chrono::duration<double>>{};
+            durations.reserve(iterations);
+            start_allocations();
+            start_counters();
+            for (size_t i = 0; i < iterations; ++i) {
+                if (cache_evictor) {
+                    pause_counters();
+                    cache_evictor->evict();
+                    resume_counters();
+                }
+
+                const auto start = std::chrono::steady_clock::now();
+                const auto current = solve_loaded(input);
+                durations.emplace_back(std::chrono::steady_clock::now() - start);
+
+                check_answers_match(answers, current);
             }
-            std::cout << "Time taken: "
-                      << std::chrono::duration_cast<std::chrono::microseconds>(result.time_elapsed).count() << "μs"
-                      << std::endl;
+            auto counters = stop_counters(iterations);
+            auto allocations = stop_allocations(iterations);
+
+            return BenchmarkResult{answers,
+                                   calculate_statistics(durations, warmup),
+                                   std::move(counters),
+                                   std::move(allocations),
+                                   memory_meter.stop()};
+        }
+
+        Report run() override {
+            auto result = get_answers();
+            return Report{format(result.answers),
+                          result.time_elapsed,
+                          std::move(result.phases),
+                          std::nullopt,
+                          std::move(result.counters),
+                          std::move(result.allocations),
+                          result.memory,
+                          result.cache,
+                          result.snapshot,
+                          std::nullopt};
+        }
+
+        // Reports the median as the time taken.
+        Report run_benchmark(size_t iterations, size_t warmup) override {
+            auto result = benchmark(iterations, warmup);
+            return Report{format(result.answers),
+                          result.statistics.median,
+                          {},
+                          result.statistics,
+                          std::move(result.counters),
+                          std::move(result.allocations),
+                          result.memory,
+                          std::nullopt,
+                          std::nullopt,
+                          std::nullopt};
+        }
+
+        void set_input(const std::string &path) override { input_file_path = path; }
+
+        void configure(const Options &options) override {
+            concurrent_parts = options.concurrent_parts;
+            measure_memory = options.jobs == 1 && !options.throughput;
+            if (options.perf_counters && !perf_counters) {
+                perf_counters.emplace();
+            } else if (!options.perf_counters) {
+                perf_counters.reset();
+            }
+
+            if (options.cold_cache && !cache_evictor) {
+                cache_evictor.emplace();
+            } else if (!options.cold_cache) {
+                cache_evictor.reset();
+            }
+
+            if (options.cache_dir) {
+                answer_cache.emplace(*options.cache_dir, typeid(*this).name(), cache_version());
+            } else {
+                answer_cache.reset();
+            }
+
+            if (options.snapshot_dir) {
+                snapshot_store.emplace(*options.snapshot_dir, typeid(*this).name(), snapshot_version());
+            } else {
+                snapshot_store.reset();
+            }
+        }
+
+        static std::vector<FormattedAnswer> format(const Answers &answers) {
+            auto formatted = std::vector<FormattedAnswer>{};
+            for (const auto &answer : answers) {
+                auto value = std::ostringstream{};
+                value << answer.value;
+                formatted.emplace_back(FormattedAnswer{answer.descriptor, value.str()});
+            }
+            return formatted;
+        }
+
+        void print_answers() { print_report(run(), std::cout); }
+        void print_benchmark(size_t iterations, size_t warmup) {
+            print_report(run_benchmark(iterations, warmup), std::cout);
         }
 
       protected:
-        virtual Answers solve(std::ifstream &input) const = 0;
+        // Records how long the scope it lives in took as a named phase of the current solve. Phases show up alongside
+        // the answers in AnswersWithDuration & in the print_answers output, & as spans in traces.
+        class PhaseTimer {
+          public:
+            PhaseTimer(Phases &phases, std::mutex &mutex, const char *const name)
+                : phases{phases}, mutex{mutex}, name{name}, start{std::chrono::steady_clock::now()}, span{name} {}
+            PhaseTimer(const PhaseTimer &) = delete;
+            PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+            ~PhaseTimer() {
+                const auto time_elapsed = std::chrono::steady_clock::now() - start;
+                const auto lock = std::lock_guard{mutex};
+                phases.emplace_back(Phase{name, time_elapsed});
+            }
+
+          private:
+            Phases &phases;
+            std::mutex &mutex;
+            const char *const name;
+            const std::chrono::steady_clock::time_point start;
+            const TraceSpan span;
+        };
+
+        // e.g. `const auto timer = time_phase("parse");`
+        PhaseTimer time_phase(const char *const name) const {
+            return PhaseTimer{recorded_phases, recorded_phases_mutex, name};
+        }
+
+        // Evaluates parts that only share read-only state (typically the parsed input) & returns their answers in
+        // order. With --concurrent-parts each part runs on its own thread, otherwise they run one after another. Each
+        // is timed (& traced) as phase "part N", so parts shouldn't time themselves.
+        template <typename... Parts> Answers solve_parts(Parts &&...parts) const {
+            static_assert(sizeof...(Parts) <= std::size(PART_PHASES), "a phase name for every part");
+
+            auto number = size_t{0};
+            if (!concurrent_parts) {
+                // Braced initialisers are evaluated in order, so the numbering matches.
+                return Answers{timed_part(number++, parts)...};
+            }
+
+            auto futures = std::vector<std::future<Answer>>{};
+            (futures.emplace_back(
+                 std::async(std::launch::async, [this, &parts, n = number++]() { return timed_part(n, parts); })),
+             ...);
+
+            auto answers = Answers{};
+            for (auto &future : futures) {
+                answers.emplace_back(future.get());
+            }
+            return answers;
+        }
+
+        // For structures that only live as long as the current solve, which are then all freed at once after it, e.g.
+        // `auto seen = std::pmr::unordered_set<Point, Point::Hash>{arena()};`
+        std::pmr::memory_resource *arena() const { return solve_arena.resource(concurrent_parts); }
+
+        virtual InputMode input_mode() const { return InputMode::stream; }
+
+        // Part of the answer cache key; bump it when a change could alter the answers, so stale ones aren't reused.
+        virtual unsigned cache_version() const { return 1; }
+
+        // Likewise for snapshots (see parse_or_load()); bump it when the parsed representation or its encoding changes.
+        virtual unsigned snapshot_version() const { return 1; }
+
+        // Parses the input with `parse(input)`, or with --snapshot loads what parsing the same input saved before. The
+        // parsed type provides `void write_snapshot(SnapshotWriter &) const` & `static Parsed
+        // read_snapshot(SnapshotReader &)`. Timed as a "parse" or "load snapshot" phase.
+        template <typename Parse> auto parse_or_load(std::string_view input, Parse &&parse) const {
+            if (!snapshot_store) {
+                const auto timer = time_phase("parse");
+                return parse(input);
+            }
+            return parse_or_load_snapshot([&]() { return snapshot_store->key(input); }, [&]() { return parse(input); });
+        }
+
+        // As above for stream days, whose stream gets read through for the hash & rewound before parsing.
+        template <typename Parse> auto parse_or_load(std::istream &input, Parse &&parse) const {
+            if (!snapshot_store) {
+                const auto timer = time_phase("parse");
+                return parse(input);
+            }
+
+            const auto key_of_stream = [&]() {
+                auto contents = std::ostringstream{};
+                contents << input.rdbuf();
+                const auto key = snapshot_store->key(contents.view());
+                input.clear();
+                input.seekg(0);
+                return key;
+            };
+            return parse_or_load_snapshot(key_of_stream, [&]() { return parse(input); });
+        }
+
+#ifdef AOC_EMBED_INPUT
+        // With `make EMBED_INPUT=1`, days whose solve is constexpr work out the answers for the embedded input.txt at
+        // compile time & return them here; they're used instead of solving that file. Benchmarks still solve it.
+        virtual std::optional<Answers> embedded_answers() const { return std::nullopt; }
+#endif
+
+        // Solvers override exactly one of these, matching what input_mode() returns.
+        virtual Answers solve(__attribute__((unused)) std::istream &input) const {
+            throw Error{"stream_input_not_supported"};
+        }
+        virtual Answers solve_mapped(__attribute__((unused)) std::string_view input) const {
+            throw Error{"mapped_input_not_supported"};
+        }
 
       private:
         std::string input_file_path;
+        bool concurrent_parts = false;
+        bool measure_memory = true;
+        mutable Phases recorded_phases;
+        mutable std::mutex recorded_phases_mutex;
+        std::optional<PerfCounters> perf_counters;
+        std::optional<AnswerCache> answer_cache;
+        std::optional<CacheEvictor> cache_evictor;
+        std::optional<SnapshotStore> snapshot_store;
+        mutable std::optional<SnapshotUse> snapshot_use;
+        mutable Arena solve_arena;
+#ifdef AOC_ALLOC_TRACKING
+        AllocationMeter allocation_meter;
+#endif
+
+        struct LoadedInput {
+            std::optional<MappedFile> mapped;
+            std::unique_ptr<std::istream> stream;
+        };
+
+        LoadedInput load_input() const {
+            const auto span = TraceSpan{"load input"};
+            if (input_mode() == InputMode::mapped) {
+                return LoadedInput{MappedFile{input_file_path}, nullptr};
+            }
+
+            // Pipes can't be rewound for repeated solves, so anything that isn't a regular file is read up front.
+            if (!std::filesystem::is_regular_file(input_file_path)) {
+                const auto contents = MappedFile{input_file_path};
+                return LoadedInput{std::nullopt, std::make_unique<std::istringstream>(std::string{contents.view()})};
+            }
+
+            auto input = std::make_unique<std::ifstream>(input_file_path, std::ios::in);
+            if (!input->is_open()) {
+                throw Error{"file_open_failed"};
+            }
+            return LoadedInput{std::nullopt, std::move(input)};
+        }
+
+        AnswerCache::Key cache_key_of(LoadedInput &input) const {
+            if (input.mapped) {
+                return answer_cache->key(input.mapped->view());
+            }
+
+            // solve_loaded() rewinds the stream before solving.
+            input.stream->clear();
+            input.stream->seekg(0);
+            const auto contents = std::string{std::istreambuf_iterator<char>{*input.stream}, {}};
+            return answer_cache->key(contents);
+        }
+
+        void start_counters() {
+            if (perf_counters) {
+                perf_counters->start();
+            }
+        }
+
+        void pause_counters() {
+            if (perf_counters) {
+                perf_counters->pause();
+            }
+        }
+
+        void resume_counters() {
+            if (perf_counters) {
+                perf_counters->resume();
+            }
+        }
+
+        std::optional<Counters> stop_counters(size_t runs) {
+            if (!perf_counters) {
+                return std::nullopt;
+            }
+            return perf_counters->stop(runs);
+        }
+
+        void start_allocations() {
+#ifdef AOC_ALLOC_TRACKING
+            allocation_meter.start();
+#endif
+        }
+
+        std::optional<Allocations> stop_allocations(__attribute__((unused)) size_t runs) const {
+#ifdef AOC_ALLOC_TRACKING
+            return allocation_meter.stop(runs);
+#else
+            return std::nullopt;
+#endif
+        }
+
+        Answers solve_loaded(LoadedInput &input) const {
+            const auto span = TraceSpan{"solve"};
+            recorded_phases.clear();
+            snapshot_use.reset();
+            const auto arena_scope = Arena::Scope{solve_arena};
+
+            auto answers = Answers{};
+            if (input.mapped) {
+                answers = solve_mapped(input.mapped->view());
+            } else {
+                // Rewind so that the same stream can be solved repeatedly.
+                input.stream->clear();
+                input.stream->seekg(0);
+                answers = solve(*input.stream);
+            }
+            return answers;
+        }
+
+        // Hashing the source counts as loading, since a snapshot can't be used without.
+        template <typename Key, typename Parse> auto parse_or_load_snapshot(Key &&key_of_input, Parse &&parse) const {
+            using Parsed = std::invoke_result_t<Parse>;
+            const auto load_start = std::chrono::steady_clock::now();
+            auto key = SnapshotStore::Key{};
+            {
+                const auto timer = time_phase("load snapshot");
+                key = key_of_input();
+                if (const auto entry = snapshot_store->load(key)) {
+                    try {
+                        auto reader = SnapshotReader{entry->payload()};
+                        auto parsed = Parsed::read_snapshot(reader);
+                        if (reader.done()) {
+                            snapshot_use = SnapshotUse{true,
+                                                       entry->parse_time,
+                                                       std::chrono::steady_clock::now() - load_start,
+                                                       entry->payload().size()};
+                            return parsed;
+                        }
+                    } catch (const std::exception &) {
+                        // A snapshot that doesn't read back is as good as none.
+                    }
+                }
+            }
+
+            const auto parse_start = std::chrono::steady_clock::now();
+            auto parsed = [&]() {
+                const auto timer = time_phase("parse");
+                return parse();
+            }();
+            const auto parse_time = std::chrono::steady_clock::now() - parse_start;
+
+            auto writer = SnapshotWriter{};
+            parsed.write_snapshot(writer);
+            snapshot_store->store(
+                key, std::chrono::duration_cast<std::chrono::nanoseconds>(parse_time), writer.payload());
+            snapshot_use = SnapshotUse{false, parse_time, {}, writer.payload().size()};
+            return parsed;
+        }
+
+        static constexpr const char *PART_PHASES[] = {"part 1", "part 2"};
+
+        template <typename Part> Answer timed_part(size_t index, Part &part) const {
+            const auto timer = time_phase(PART_PHASES[index]);
+            return part();
+        }
+
+        static void check_answers_match(const Answers &expected, const Answers &actual) {
+            const auto same = expected.size() == actual.size() &&
+                std::equal(expected.begin(), expected.end(), actual.begin(), [](const auto &a, const auto &b) {
+                                  return a.descriptor == b.descriptor && a.value == b.value;
+                              });
+            if (!same) {
+                throw Error{"answers_differ_between_runs"};
+            }
+        }
+
+        static Statistics calculate_statistics(std::vector<std::chrono::duration<double>> durations, size_t warmup) {
+            std::sort(durations.begin(), durations.end());
+
+            const auto n = durations.size();
+            const auto mean = std::accumulate(durations.begin(), durations.end(), std::chrono::duration<double>{}) /
+                static_cast<double>(n);
+            const auto variance = std::accumulate(durations.begin(),
+                                                  durations.end(),
+                                                  0.0,
+                                                  [=](double acc, auto d) {
+                                                      const auto diff = (d - mean).count();
+                                                      return acc + diff * diff;
+                                                  }) /
+                static_cast<double>(n > 1 ? n - 1 : 1);
+
+            return Statistics{
+                n,
+                warmup,
+                durations.front(),
+                n % 2 == 1 ? durations[n / 2] : (durations[n / 2 - 1] + durations[n / 2]) / 2.0,
+                mean,
+                durations[static_cast<size_t>(std::ceil(0.99 * static_cast<double>(n))) - 1],
+                std::chrono::duration<double>{std::sqrt(variance)},
+            };
+        }
     };
+
+    // Solves once, or benchmarks if the command line asked for it. Throws if the solve went over --memory-budget.
+    inline Report run(Runnable &solver, const Options &options) {
+        solver.configure(options);
+
+        const auto iterations = options.benchmark.iterations;
+        auto report = Report{};
+        if (iterations > 0) {
+            auto environment = prepare_benchmark_environment(options);
+            report = solver.run_benchmark(iterations, options.benchmark.warmup.value_or(iterations / 10));
+            report.environment = std::move(environment);
+        } else {
+            report = solver.run();
+        }
+
+        if (options.memory_budget_kib && report.memory && report.memory->solve_delta_kib > *options.memory_budget_kib) {
+            throw std::runtime_error{"memory_budget_exceeded"};
+        }
+        return report;
+    }
+
+    namespace Detail {
+        // "-" reads standard input, which may be a pipe.
+        inline std::string input_path(const std::string &arg) { return arg == "-" ? "/dev/stdin" : arg; }
+
+        // One input path per line, blank lines ignored.
+        inline std::vector<std::string> read_input_list(const std::string &list_path) {
+            auto list = std::ifstream{input_path(list_path)};
+            if (!list.is_open()) {
+                throw std::runtime_error{"input_list_open_failed"};
+            }
+
+            auto paths = std::vector<std::string>{};
+            for (auto line = std::string{}; std::getline(list, line);) {
+                const auto path = Utils::trim(line);
+                if (!path.empty()) {
+                    paths.emplace_back(path);
+                }
+            }
+            return paths;
+        }
+
+        // Directories stand for every regular file in them, in name order.
+        inline std::vector<std::string> expand_directories(const std::vector<std::string> &paths) {
+            auto expanded = std::vector<std::string>{};
+            for (const auto &path : paths) {
+                if (!std::filesystem::is_directory(path)) {
+                    expanded.emplace_back(path);
+                    continue;
+                }
+
+                auto files = std::vector<std::string>{};
+                for (const auto &entry : std::filesystem::directory_iterator{path}) {
+                    if (entry.is_regular_file()) {
+                        files.emplace_back(entry.path().string());
+                    }
+                }
+                if (files.empty()) {
+                    throw std::runtime_error{"empty_input_directory"};
+                }
+                std::sort(files.begin(), files.end());
+                expanded.insert(expanded.end(), files.begin(), files.end());
+            }
+            return expanded;
+        }
+
+        // Of durations already sorted, as Solver's statistics take them.
+        inline std::chrono::duration<double> percentile(const std::vector<std::chrono::duration<double>> &sorted,
+                                                        double fraction) {
+            return sorted[static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size()))) - 1];
+        }
+    } // namespace Detail
+
+    // Solves every input on --jobs threads, which take inputs from each other as they run out (see work_stealing.h).
+    // Each thread has its own solver for every input it takes, so that arenas & the like are reused per thread. Answers
+    // are printed in input order once all are solved, followed by inputs/s & per-input latency percentiles.
+    template <typename S>
+    int solve_throughput(const Registration<S> &registration,
+                         const std::vector<std::string> &inputs,
+                         const Options &options) {
+        const auto jobs = options.jobs == 0 ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : options.jobs;
+        const auto threads = std::min(jobs, inputs.size());
+
+        auto solvers = std::vector<std::unique_ptr<Runnable>>{};
+        for (size_t i = 0; i < threads; ++i) {
+            solvers.emplace_back(registration.make(Detail::input_path(inputs.front())));
+        }
+
+        struct Outcome {
+            std::optional<Report> report;
+            std::string error;
+            std::chrono::duration<double> latency;
+        };
+        auto outcomes = std::vector<Outcome>(inputs.size());
+
+        const auto start = std::chrono::steady_clock::now();
+        run_work_stealing(inputs.size(), threads, [&](size_t i, size_t worker) {
+            const auto span = TraceSpan{inputs[i].c_str()};
+            const auto input_start = std::chrono::steady_clock::now();
+            try {
+                solvers[worker]->set_input(Detail::input_path(inputs[i]));
+                outcomes[i].report = run(*solvers[worker], options);
+            } catch (const std::exception &e) {
+                outcomes[i].error = e.what();
+            }
+            outcomes[i].latency = std::chrono::steady_clock::now() - input_start;
+        });
+        const auto wall_time = std::chrono::steady_clock::now() - start;
+
+        auto failures = size_t{0};
+        auto latencies = std::vector<std::chrono::duration<double>>{};
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const auto &outcome = outcomes[i];
+            latencies.emplace_back(outcome.latency);
+
+            if (options.json) {
+                if (outcome.report) {
+                    write_json(registration.year, registration.day, *outcome.report, std::cout, inputs[i]);
+                } else {
+                    write_json_error(registration.year, registration.day, outcome.error, std::cout, inputs[i]);
+                }
+            } else {
+                std::cout << "=== " << inputs[i] << " ===\n";
+                if (outcome.report) {
+                    print_answers(outcome.report->answers, std::cout);
+                } else {
+                    std::cout << "Failed: " << outcome.error << '\n';
+                }
+            }
+            failures += !outcome.report;
+        }
+
+        // The summary isn't a result, so leave it out of JSON output.
+        if (!options.json) {
+            std::sort(latencies.begin(), latencies.end());
+            print_throughput(Throughput{inputs.size(),
+                                        failures,
+                                        threads,
+                                        wall_time,
+                                        Detail::percentile(latencies, 0.5),
+                                        Detail::percentile(latencies, 0.9),
+                                        Detail::percentile(latencies, 0.99),
+                                        latencies.back()},
+                             std::cout);
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    // Feeds each input to S's incremental solver as it's read (so standard input can be a log that's still being
+    // written), printing the answers so far at most every --stream milliseconds & the final ones at its end.
+    template <typename S> void solve_streaming(const std::vector<std::string> &inputs, const Options &options) {
+        using Clock = std::chrono::steady_clock;
+        const auto interval = std::chrono::milliseconds{*options.stream_interval_ms};
+
+        for (const auto &input : inputs) {
+            if (inputs.size() > 1) {
+                std::cout << "=== " << input << " ===\n";
+            }
+
+            const auto span = TraceSpan{input.c_str()};
+            auto incremental = typename S::Incremental{};
+            incremental.limit_record_size(STREAM_MAX_RECORD_SIZE);
+            auto bytes = size_t{0};
+            auto last_snapshot = Clock::now();
+            Detail::read_chunks(Detail::input_path(input), [&](std::string_view chunk) {
+                incremental.feed(chunk);
+                bytes += chunk.size();
+                if (Clock::now() - last_snapshot >= interval) {
+                    std::cout << "--- After " << bytes << " bytes ---\n";
+                    print_answers(S::format(incremental.snapshot()), std::cout);
+                    std::cout.flush();
+                    last_snapshot = Clock::now();
+                }
+            });
+            print_answers(S::format(incremental.finish()), std::cout);
+        }
+    }
+
+    // Entry point shared by every solver binary; handles the common command line switches. Solves the inputs named on
+    // the command line (files, or directories of them) & in any --inputs list one after another with the same solver,
+    // or `default_input_file_path` if none were given. With --throughput they're solved concurrently instead.
+    template <typename S>
+    int solver_main(const Registration<S> &registration,
+                    int argc,
+                    char **argv,
+                    const char *const default_input_file_path) {
+        const auto options = parse_options(argc, argv);
+        if (!options) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        try {
+            start_tracing(*options);
+
+            if (options->scaling.enabled) {
+                const auto entries = Registry::instance().all();
+                const auto entry = std::find_if(entries.begin(), entries.end(), [&](const auto &e) {
+                    return e.year == registration.year && e.day == registration.day;
+                });
+                print_scaling(measure_scaling(*entry, *options), std::cout);
+                return 0;
+            }
+
+            auto inputs = options->positional;
+            if (options->input_list) {
+                const auto listed = Detail::read_input_list(*options->input_list);
+                inputs.insert(inputs.end(), listed.begin(), listed.end());
+            }
+            inputs = Detail::expand_directories(inputs);
+            if (inputs.empty()) {
+                inputs.emplace_back(default_input_file_path);
+            }
+
+            if (options->throughput) {
+                const auto status = solve_throughput(registration, inputs, *options);
+                finish_tracing(*options);
+                return status;
+            }
+
+            if (options->stream_interval_ms) {
+                if constexpr (HasIncrementalSolver<S>) {
+                    solve_streaming<S>(inputs, *options);
+                    finish_tracing(*options);
+                    return 0;
+                } else {
+                    throw std::runtime_error{"incremental_input_not_supported"};
+                }
+            }
+
+            // Baselines are per day, so there'd be no telling the inputs apart.
+            if (options->compare_baseline && inputs.size() > 1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+
+            const auto baseline =
+                options->compare_baseline ? load_baseline(*options->compare_baseline) : std::vector<BaselineEntry>{};
+            const auto batch = inputs.size() > 1;
+            const auto threshold = static_cast<double>(options->regression_threshold_percent) / 100.0;
+
+            // Reused for every input, so that anything it holds on to between solves stays allocated & cached.
+            const auto solver = registration.make(Detail::input_path(inputs.front()));
+
+            auto total = std::chrono::duration<double>{};
+            auto failures = size_t{0};
+            auto regressions = size_t{0};
+            for (const auto &input : inputs) {
+                if (batch && !options->json) {
+                    std::cout << "=== " << input << " ===\n";
+                }
+
+                const auto span = TraceSpan{input.c_str()};
+                solver->set_input(Detail::input_path(input));
+                auto report = std::optional<Report>{};
+                try {
+                    report = run(*solver, *options);
+                } catch (const std::exception &e) {
+                    ++failures;
+                    if (options->json) {
+                        write_json_error(registration.year, registration.day, e.what(), std::cout, batch ? input : "");
+                    } else {
+                        std::cout << "Failed: " << e.what() << '\n';
+                    }
+                    continue;
+                }
+
+                total += report->time_elapsed;
+                if (options->json) {
+                    write_json(registration.year, registration.day, *report, std::cout, batch ? input : "");
+                } else {
+                    print_report(*report, std::cout);
+                }
+
+                if (options->compare_baseline) {
+                    // Keep stdout parseable when writing JSON.
+                    auto &out = options->json ? std::cerr : std::cout;
+                    if (!check_against_baseline(
+                            baseline, registration.year, registration.day, *report, threshold, out)) {
+                        ++regressions;
+                    }
+                }
+            }
+
+            if (batch && !options->json) {
+                std::cout << "=== Inputs solved: " << inputs.size() << " (" << failures << " failed) ===\n"
+                          << "Total time taken: "
+                          << std::chrono::duration_cast<std::chrono::microseconds>(total).count() << "μs"
+                          << '\n';
+            }
+
+            finish_tracing(*options);
+            return failures == 0 && regressions == 0 ? 0 : 1;
+        } catch (const std::exception &e) {
+            std::cerr << "Failed: " << e.what() << std::endl;
+            // What was traced up to the failure is often what explains it.
+            try {
+                finish_tracing(*options);
+            } catch (const std::exception &trace_error) {
+                std::cerr << "Failed: " << trace_error.what() << std::endl;
+            }
+            return 1;
+        }
+    }
 } // namespace Common
 
 #endif
@@ -0,0 +1,153 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include "options.h"
+#include "results.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Common {
+#ifdef AOC_TRACE
+    // Spans recorded while --trace is on, written out as Chrome trace events ("X" events with thread IDs), which
+    // chrome://tracing & ui.perfetto.dev show as a per-thread timeline.
+    class Tracer {
+      public:
+        using Clock = std::chrono::steady_clock;
+
+        static Tracer &instance() {
+            static auto tracer = Tracer{};
+            return tracer;
+        }
+
+        void enable() { enabled_flag = true; }
+        bool enabled() const { return enabled_flag.load(std::memory_order_relaxed); }
+
+        // `name` only has to live until this returns.
+        void record(const char *const name,
+                    std::optional<size_t> index,
+                    Clock::time_point start,
+                    Clock::time_point end) {
+            auto label = std::string{name};
+            if (index) {
+                label += ' ' + std::to_string(*index);
+            }
+            const auto tid = thread_id();
+
+            const auto lock = std::lock_guard{mutex};
+            events.emplace_back(Event{std::move(label), tid, start - origin, end - start});
+        }
+
+        void write(std::ostream &out) const {
+            const auto lock = std::lock_guard{mutex};
+            const auto pid = ::getpid();
+
+            out << "{\"traceEvents\":[";
+            for (size_t i = 0; i < events.size(); ++i) {
+                const auto &event = events[i];
+                out << (i > 0 ? ",\n" : "\n") << "{\"name\":";
+                Detail::write_json_string(event.name, out);
+                out << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << event.tid
+                    << ",\"ts\":" << Detail::to_microseconds(event.start)
+                    << ",\"dur\":" << Detail::to_microseconds(event.duration) << '}';
+            }
+            out << "\n]}\n";
+        }
+
+      private:
+        struct Event {
+            std::string name;
+            uint32_t tid;
+            // From when tracing started.
+            std::chrono::duration<double> start;
+            std::chrono::duration<double> duration;
+        };
+
+        const Clock::time_point origin = Clock::now();
+        std::atomic<bool> enabled_flag = false;
+        mutable std::mutex mutex;
+        std::vector<Event> events;
+
+        Tracer() = default;
+
+        // Small & stable per thread, unlike std::thread::id.
+        static uint32_t thread_id() {
+            static auto next = std::atomic<uint32_t>{1};
+            thread_local const auto id = next++;
+            return id;
+        }
+    };
+
+    // Records the scope it lives in as a span, named e.g. "fold 3" when given an index. Usable (& ignored) in constant
+    // evaluation, so constexpr solvers can hold spans too.
+    class TraceSpan {
+      public:
+        constexpr explicit TraceSpan(const char *const name) : name{name} { begin(); }
+        constexpr TraceSpan(const char *const name, size_t index) : name{name}, index{index} { begin(); }
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+
+        constexpr ~TraceSpan() {
+            if (!std::is_constant_evaluated() && active) {
+                Tracer::instance().record(name, index, start, Tracer::Clock::now());
+            }
+        }
+
+      private:
+        const char *const name;
+        const std::optional<size_t> index;
+        bool active = false;
+        Tracer::Clock::time_point start{};
+
+        constexpr void begin() {
+            if (!std::is_constant_evaluated() && Tracer::instance().enabled()) {
+                active = true;
+                start = Tracer::Clock::now();
+            }
+        }
+    };
+
+    inline void start_tracing(const Options &options) {
+        if (options.trace_file) {
+            Tracer::instance().enable();
+        }
+    }
+
+    inline void finish_tracing(const Options &options) {
+        if (!options.trace_file) {
+            return;
+        }
+        auto file = std::ofstream{*options.trace_file};
+        Tracer::instance().write(file);
+        if (!file.flush()) {
+            throw std::runtime_error{"trace_write_failed"};
+        }
+    }
+#else
+    // Without AOC_TRACE (`make TRACE=1`) spans are empty & compile away entirely.
+    class TraceSpan {
+      public:
+        constexpr explicit TraceSpan(const char *const) {}
+        constexpr TraceSpan(const char *const, size_t) {}
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+        // User-provided, so that unused span variables don't warn.
+        constexpr ~TraceSpan() {}
+    };
+
+    inline void start_tracing(const Options &) {}
+    inline void finish_tracing(const Options &) {}
+#endif
+} // namespace Common
+
+#endif
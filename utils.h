@@ -1,9 +1,28 @@
 #ifndef _UTILS_H_
 #define _UTILS_H_
 
+#include <array>
+#include <bit>
 #include <charconv>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <istream>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace Utils {
     template <typename T = unsigned long long> T str_to_int(const std::string_view &str) {
@@ -14,6 +33,341 @@ namespace Utils {
         }
         return number;
     }
+
+    // Map from character to T built at compile time, so looking one up is a single indexed load. e.g.
+    //  static constexpr auto FLOOR_CHANGE = Utils::CharTable<int>{{'(', 1}, {')', -1}};
+    //  static constexpr auto VOWELS = Utils::CharTable<bool>{"aeiou"};
+    template <typename T> class CharTable {
+      public:
+        struct Entry {
+            char key;
+            T value;
+        };
+
+        constexpr CharTable(std::initializer_list<Entry> entries) {
+            for (const auto &entry : entries) {
+                values[index(entry.key)] = entry.value;
+                present[index(entry.key)] = true;
+            }
+        }
+
+        // Every one of `keys` maps to `value`.
+        constexpr explicit CharTable(std::string_view keys, const T &value) {
+            for (const auto key : keys) {
+                values[index(key)] = value;
+                present[index(key)] = true;
+            }
+        }
+
+        // A set of characters: every one of `keys` maps to true.
+        constexpr explicit CharTable(std::string_view keys)
+            requires std::is_same_v<T, bool>
+            : CharTable{keys, true} {}
+
+        constexpr bool contains(char c) const { return present[index(c)]; }
+
+        // Throws for characters that aren't in the table.
+        constexpr const T &at(char c) const {
+            if (!contains(c)) {
+                throw std::out_of_range{"unknown_character"};
+            }
+            return values[index(c)];
+        }
+
+        // Unchecked; T{} for characters that aren't in the table.
+        constexpr const T &operator[](char c) const { return values[index(c)]; }
+
+      private:
+        std::array<T, 256> values{};
+        std::array<bool, 256> present{};
+
+        static constexpr size_t index(char c) { return static_cast<unsigned char>(c); }
+    };
+
+    constexpr bool is_whitespace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+    constexpr std::string_view trim(std::string_view str) {
+        while (!str.empty() && is_whitespace(str.front())) {
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && is_whitespace(str.back())) {
+            str.remove_suffix(1);
+        }
+        return str;
+    }
+
+    // Skips leading whitespace, parses the integer that follows & advances str past it.
+    // Returns false once str has nothing but whitespace left.
+    template <typename T> bool consume_int(std::string_view &str, T &out) {
+        while (!str.empty() && is_whitespace(str.front())) {
+            str.remove_prefix(1);
+        }
+        if (str.empty()) {
+            return false;
+        }
+
+        auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), out);
+        if (err != std::errc{}) {
+            throw std::runtime_error{"malformed_input"};
+        }
+        str.remove_prefix(ptr - str.data());
+        return true;
+    }
+
+    namespace Detail {
+        // Bit i of the mask is set where p[i] == c, for the SCAN_WIDTH bytes at p.
+#if defined(__AVX2__)
+        inline constexpr size_t SCAN_WIDTH = 32;
+        inline uint64_t match_mask(const char *const p, char c) {
+            const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+        }
+#elif defined(__SSE2__)
+        inline constexpr size_t SCAN_WIDTH = 16;
+        inline uint64_t match_mask(const char *const p, char c) {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+        }
+#else
+        inline constexpr size_t SCAN_WIDTH = 8;
+        inline uint64_t match_mask(const char *const p, char c) {
+            auto mask = uint64_t{0};
+            for (size_t i = 0; i < SCAN_WIDTH; ++i) {
+                mask |= uint64_t{p[i] == c} << i;
+            }
+            return mask;
+        }
+#endif
+
+        // The scans below fall back to their scalar tails in constant evaluation, where intrinsics can't run.
+        constexpr size_t count_char(std::string_view str, char c) {
+            auto count = size_t{0};
+            auto i = size_t{0};
+            if (!std::is_constant_evaluated()) {
+                for (; i + SCAN_WIDTH <= str.size(); i += SCAN_WIDTH) {
+                    count += static_cast<size_t>(std::popcount(match_mask(str.data() + i, c)));
+                }
+            }
+            for (; i < str.size(); ++i) {
+                count += str[i] == c;
+            }
+            return count;
+        }
+
+        // Calls field(std::string_view) for every piece of str between delimiters, including the last.
+        template <typename F> constexpr void for_each_field(std::string_view str, char delimiter, F &&field) {
+            auto start = size_t{0};
+            auto i = size_t{0};
+            if (!std::is_constant_evaluated()) {
+                for (; i + SCAN_WIDTH <= str.size(); i += SCAN_WIDTH) {
+                    for (auto mask = match_mask(str.data() + i, delimiter); mask != 0; mask &= mask - 1) {
+                        const auto end = i + static_cast<size_t>(std::countr_zero(mask));
+                        field(str.substr(start, end - start));
+                        start = end + 1;
+                    }
+                }
+            }
+            for (; i < str.size(); ++i) {
+                if (str[i] == delimiter) {
+                    field(str.substr(start, i - start));
+                    start = i + 1;
+                }
+            }
+            field(str.substr(start));
+        }
+
+        // 1-8 ASCII digits converted at once, as the 8 bytes of a little endian word (SWAR). Nothing if any of them
+        // isn't a digit.
+        inline std::optional<uint32_t> parse_eight_digits(std::string_view digits) {
+            // Left pad with '0's, so the last digit is always in the top byte.
+            auto chunk = uint64_t{0x3030303030303030};
+            std::memcpy(reinterpret_cast<char *>(&chunk) + (8 - digits.size()), digits.data(), digits.size());
+            if ((chunk & 0xF0F0F0F0F0F0F0F0) != 0x3030303030303030 ||
+                ((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) != 0x3030303030303030) {
+                return std::nullopt;
+            }
+
+            chunk -= 0x3030303030303030;
+            // Pairs of digits, then fours, then all eight.
+            chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FF;
+            chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFF;
+            chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFF;
+            return static_cast<uint32_t>(chunk);
+        }
+
+        // std::from_chars only becomes constexpr in C++23.
+        template <typename T> constexpr T constexpr_str_to_int(std::string_view str) {
+            const auto negative = std::is_signed_v<T> && !str.empty() && str.front() == '-';
+            if (negative) {
+                str.remove_prefix(1);
+            }
+            if (str.empty()) {
+                throw std::runtime_error{"malformed_input"};
+            }
+
+            auto number = T{0};
+            for (const auto c : str) {
+                if (c < '0' || c > '9') {
+                    throw std::runtime_error{"malformed_input"};
+                }
+                number = static_cast<T>(number * 10 + (c - '0'));
+            }
+            return negative ? static_cast<T>(-number) : number;
+        }
+
+        template <typename T> constexpr T parse_field(std::string_view field) {
+            if (std::is_constant_evaluated()) {
+                return constexpr_str_to_int<T>(trim(field));
+            }
+            if (std::endian::native == std::endian::little && !field.empty() && field.size() <= 8) {
+                const auto value = parse_eight_digits(field);
+                if (value && *value <= static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                    return static_cast<T>(*value);
+                }
+            }
+            // Signs, long numbers, stray whitespace & anything malformed.
+            return str_to_int<T>(trim(field));
+        }
+    } // namespace Detail
+
+    // Calls number(T) for each integer of a list as parse_int_list takes them, without building the list. Usable in
+    // constant expressions (as is parse_int_list), where malformed input fails the build.
+    template <typename T, typename F> constexpr void for_each_int(std::string_view str, char delimiter, F &&number) {
+        str = trim(str);
+        if (str.empty()) {
+            return;
+        }
+        Detail::for_each_field(str, delimiter, [&](std::string_view field) { number(Detail::parse_field<T>(field)); });
+    }
+
+    // Parses a whole buffer of integers separated by `delimiter`, e.g. "3,4,3,1,2\n" or one per line with '\n', in one
+    // pass: the vector is sized from a vectorised count of delimiters, delimiters are found a block (16 or 32 bytes,
+    // depending on SSE2/AVX2) at a time & numbers of up to 8 digits are converted without a per-digit loop. Throws
+    // malformed_input for any field that isn't an integer.
+    template <typename T> constexpr std::vector<T> parse_int_list(std::string_view str, char delimiter = ',') {
+        auto numbers = std::vector<T>{};
+        if (trim(str).empty()) {
+            return numbers;
+        }
+
+        numbers.reserve(Detail::count_char(trim(str), delimiter) + 1);
+        for_each_int<T>(str, delimiter, [&](T number) { numbers.emplace_back(number); });
+        return numbers;
+    }
+
+    // Lazy sequence of the values a coroutine co_yields, for range-for. Each value is handed out by reference to the
+    // coroutine's own, so e.g. a yielded std::string_view is only valid until the next one is asked for.
+    template <typename T> class Generator {
+      public:
+        struct promise_type {
+            const T *current = nullptr;
+            std::exception_ptr exception;
+
+            Generator get_return_object() {
+                return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(const T &value) noexcept {
+                current = std::addressof(value);
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() { exception = std::current_exception(); }
+        };
+
+        struct Sentinel {};
+
+        class Iterator {
+          public:
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            explicit Iterator(std::coroutine_handle<promise_type> coroutine) : coroutine{coroutine} {}
+
+            const T &operator*() const { return *coroutine.promise().current; }
+            Iterator &operator++() {
+                advance(coroutine);
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+            bool operator==(Sentinel) const { return coroutine.done(); }
+
+          private:
+            std::coroutine_handle<promise_type> coroutine;
+        };
+
+        Generator(Generator &&other) noexcept : coroutine{std::exchange(other.coroutine, {})} {}
+        Generator &operator=(Generator &&) = delete;
+        ~Generator() {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+        }
+
+        // Only once; the values aren't kept.
+        Iterator begin() {
+            advance(coroutine);
+            return Iterator{coroutine};
+        }
+        Sentinel end() const { return {}; }
+
+      private:
+        std::coroutine_handle<promise_type> coroutine;
+
+        explicit Generator(std::coroutine_handle<promise_type> coroutine) : coroutine{coroutine} {}
+
+        // Exceptions from the coroutine come out of whatever resumed it.
+        static void advance(std::coroutine_handle<promise_type> coroutine) {
+            coroutine.resume();
+            if (coroutine.promise().exception) {
+                std::rethrow_exception(coroutine.promise().exception);
+            }
+        }
+    };
+
+    // The records of a stream split at `delimiter` (lines by default), read a chunk at a time into one buffer that only
+    // grows for a record longer than it, so there's no allocation per record. A delimiter at the very end doesn't make
+    // an empty last record, as with std::getline. e.g.
+    //  for (const auto line : Utils::records(input)) { ... }
+    inline Generator<std::string_view> records(std::istream &input,
+                                               char delimiter = '\n',
+                                               size_t chunk_size = 64 * 1024) {
+        auto buffer = std::vector<char>(chunk_size > 0 ? chunk_size : 1);
+        // Read but not yet yielded, & how far into that there's certainly no delimiter.
+        auto start = size_t{0}, end = size_t{0}, scanned = size_t{0};
+
+        while (true) {
+            const auto *const found =
+                static_cast<const char *>(std::memchr(buffer.data() + scanned, delimiter, end - scanned));
+            if (found) {
+                const auto record_end = static_cast<size_t>(found - buffer.data());
+                co_yield std::string_view{buffer.data() + start, record_end - start};
+                start = scanned = record_end + 1;
+                continue;
+            }
+
+            // Move the partial record to the front & read more after it.
+            std::memmove(buffer.data(), buffer.data() + start, end - start);
+            end -= start;
+            start = 0;
+            scanned = end;
+            if (end == buffer.size()) {
+                buffer.resize(buffer.size() * 2);
+            }
+
+            input.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+            const auto read = static_cast<size_t>(input.gcount());
+            if (read == 0) {
+                break;
+            }
+            end += read;
+        }
+
+        if (end > start) {
+            co_yield std::string_view{buffer.data() + start, end - start};
+        }
+    }
 } // namespace Utils
 
 #endif
@@ -0,0 +1,79 @@
+#ifndef _WORK_STEALING_H_
+#define _WORK_STEALING_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace Common {
+    namespace Detail {
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<size_t> tasks;
+
+            // The owner works through its queue from the front...
+            std::optional<size_t> pop() {
+                const auto lock = std::lock_guard{mutex};
+                if (tasks.empty()) {
+                    return std::nullopt;
+                }
+                const auto task = tasks.front();
+                tasks.pop_front();
+                return task;
+            }
+
+            // ...& others steal from the back, so that they rarely contend for the same end.
+            std::optional<size_t> steal() {
+                const auto lock = std::lock_guard{mutex};
+                if (tasks.empty()) {
+                    return std::nullopt;
+                }
+                const auto task = tasks.back();
+                tasks.pop_back();
+                return task;
+            }
+        };
+    } // namespace Detail
+
+    // Calls task(index, worker) for every index in [0, count) on `threads` threads, the calling thread being worker 0.
+    // Every worker starts with an equal, contiguous share of the indices; one that runs out steals from the others, so
+    // tasks of very different lengths still keep every thread busy. `task` mustn't throw.
+    template <typename Task> void run_work_stealing(size_t count, size_t threads, Task &&task) {
+        threads = std::max<size_t>(1, std::min(threads, count));
+        auto queues = std::vector<Detail::WorkQueue>(threads);
+        for (size_t worker = 0; worker < threads; ++worker) {
+            for (auto i = worker * count / threads; i < (worker + 1) * count / threads; ++i) {
+                queues[worker].tasks.push_back(i);
+            }
+        }
+
+        // No task adds more, so a worker is done once it finds every queue empty.
+        const auto work = [&](size_t worker) {
+            while (true) {
+                auto next = queues[worker].pop();
+                for (size_t other = 1; !next && other < threads; ++other) {
+                    next = queues[(worker + other) % threads].steal();
+                }
+                if (!next) {
+                    return;
+                }
+                task(*next, worker);
+            }
+        };
+
+        auto workers = std::vector<std::thread>{};
+        for (size_t worker = 1; worker < threads; ++worker) {
+            workers.emplace_back(work, worker);
+        }
+        work(0);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+} // namespace Common
+
+#endif